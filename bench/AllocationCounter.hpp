@@ -0,0 +1,47 @@
+/**
+ * @file AllocationCounter.hpp
+ *
+ * @brief Replaces the global operator new to count heap allocations in the benchmarks.
+ *
+ * Defines the replacement operators, so include it from exactly one translation unit
+ * of an executable (every benchmark is a single source file).
+ *
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace snek::bench {
+
+inline std::atomic<uint64_t> g_allocations{0u};
+
+/**
+ * @brief Allocations made by any thread since the start of the program.
+ */
+inline auto allocationCount() -> uint64_t {
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+} // namespace snek::bench
+
+auto operator new(std::size_t size) -> void* {
+    snek::bench::g_allocations.fetch_add(1u, std::memory_order_relaxed);
+
+    if (void* ptr = std::malloc(size == 0u ? 1u : size)) {
+        return ptr;
+    }
+
+    throw std::bad_alloc();
+}
+
+auto operator delete(void* ptr) noexcept -> void {
+    std::free(ptr);
+}
+
+auto operator delete(void* ptr, std::size_t) noexcept -> void {
+    std::free(ptr);
+}
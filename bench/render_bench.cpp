@@ -0,0 +1,189 @@
+/**
+ * @file render_bench.cpp
+ * 
+ * @brief Compares one sf::Sprite draw call per entity against the batched Renderer,
+ * and rocks batched every frame against the baked StaticLayer.
+ *
+ * Opens a window (no framerate limit, no vsync), draws the same set of entities
+ * in every mode and reports draw calls, average frame time and heap allocations per frame.
+ *
+ * Usage: snek_render_bench [entities] [frames]
+ * 
+ * @authors Jacek Zub
+ */
+#include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <print>
+#include <random>
+#include <vector>
+
+#include "snek/constants.hpp"
+#include "snek/Board.hpp"
+#include "snek/Entity.hpp"
+#include "snek/Renderer.hpp"
+#include "snek/StaticLayer.hpp"
+#include "snek/TextureManager.hpp"
+
+#include "AllocationCounter.hpp"
+
+namespace {
+
+auto makeEntities(uint32_t count, sf::Vector2u window_size) -> std::vector<snek::Entity> {
+    std::mt19937 rng(1234u);
+    std::uniform_real_distribution<float> x_dist(0.f, static_cast<float>(window_size.x));
+    std::uniform_real_distribution<float> y_dist(0.f, static_cast<float>(window_size.y));
+    std::uniform_int_distribution<int32_t> dir_dist(0, 3);
+    std::uniform_int_distribution<uint32_t> sprite_dist(0u, static_cast<uint32_t>(snek::SpriteId::Count) - 1u);
+    std::uniform_real_distribution<float> rot_dist(0.f, 360.f);
+
+    std::vector<snek::Entity> entities(count);
+
+    for (auto& entity : entities) {
+        entity.position = {x_dist(rng), y_dist(rng)};
+        entity.previousPosition = entity.position;
+        entity.size = {snek::TILE_SIZE, snek::TILE_SIZE};
+        entity.direction = static_cast<snek::Direction>(dir_dist(rng));
+        entity.sprite = static_cast<snek::SpriteId>(sprite_dist(rng));
+        entity.rotationOffsetDegrees = entity.sprite == snek::SpriteId::Rock ? rot_dist(rng) : 0.f;
+    }
+
+    return entities;
+}
+
+// The pre-batching path: a fresh sprite and a draw call for every entity
+auto drawSpritePerEntity(sf::RenderWindow& window, const sf::Texture& texture, const snek::Entity& entity) -> void {
+    sf::Sprite sprite(texture);
+
+    const auto tileRect = snek::getSpriteRect(entity.sprite);
+    sprite.setTextureRect(tileRect);
+
+    const sf::Vector2f spriteSize{
+        static_cast<float>(tileRect.size.x),
+        static_cast<float>(tileRect.size.y)
+    };
+
+    sprite.setOrigin(spriteSize / 2.f);
+    sprite.setScale({
+        entity.size.x / spriteSize.x,
+        entity.size.y / spriteSize.y
+    });
+    sprite.setPosition(entity.position);
+    const float angle = (static_cast<float>(entity.direction) - 1.f) * 90.f
+        + entity.rotationOffsetDegrees;
+    sprite.setRotation(sf::degrees(angle));
+
+    window.draw(sprite);
+}
+
+struct Result {
+    double avgFrameMs;
+    uint32_t drawCalls;
+    double allocsPerFrame;
+};
+
+template<typename DrawFrame>
+auto measure(uint32_t frames, DrawFrame&& draw_frame) -> Result {
+    // Warm-up, lets the driver settle and the batches reach their capacity
+    for (uint32_t i = 0u; i < 10u; i++) {
+        draw_frame();
+    }
+
+    uint32_t draw_calls = 0u;
+    const auto allocations_before = snek::bench::allocationCount();
+    const auto start = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0u; i < frames; i++) {
+        draw_calls = draw_frame();
+    }
+
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    const auto allocations = snek::bench::allocationCount() - allocations_before;
+
+    return {elapsed / frames, draw_calls, static_cast<double>(allocations) / frames};
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int32_t {
+    const uint32_t entity_count = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 10'000u;
+    const uint32_t frames = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 300u;
+
+    sf::RenderWindow window(sf::VideoMode{{snek::WINDOW_WIDTH, snek::WINDOW_HEIGHT}}, "snek render bench");
+    window.setFramerateLimit(0u);
+    window.setVerticalSyncEnabled(false);
+
+    const auto* texture = snek::TextureManager::getTexture(snek::TextureId::Atlas);
+    if (texture == nullptr) {
+        std::println(stderr, "Failed to load texture: {}", snek::assetPath(snek::TextureId::Atlas));
+
+        return 1;
+    }
+
+    const auto entities = makeEntities(entity_count, window.getSize());
+
+    const auto per_entity = measure(frames, [&]() -> uint32_t {
+        window.clear(sf::Color::Black);
+        for (const auto& entity : entities) {
+            drawSpritePerEntity(window, *texture, entity);
+        }
+        window.display();
+
+        return static_cast<uint32_t>(entities.size());
+    });
+
+    snek::Renderer renderer{window};
+
+    const auto batched = measure(frames, [&]() -> uint32_t {
+        renderer.beginFrame();
+        for (const auto& entity : entities) {
+            renderer.draw(&entity);
+        }
+        renderer.endFrame();
+
+        return renderer.getStats().drawCalls;
+    });
+
+    // A square board a quarter full of rocks, viewed whole
+    const auto side = static_cast<uint32_t>(std::ceil(std::sqrt(4.0 * entity_count)));
+    const snek::Board board{{.width = side, .height = side, .rocks = entity_count, .seed = 1234u}};
+    const sf::FloatRect board_area{{0.f, 0.f}, sf::Vector2f{static_cast<float>(side), static_cast<float>(side)} * snek::TILE_SIZE};
+
+    const auto rocks_batched = measure(frames, [&]() -> uint32_t {
+        renderer.beginFrame();
+        renderer.setView(sf::View{board_area});
+        board.getRocks().forEach([&](const snek::Entity& rock) {
+            renderer.draw(&rock);
+        });
+        renderer.endFrame();
+
+        return renderer.getStats().drawCalls;
+    });
+
+    snek::StaticLayer static_layer;
+    static_layer.build(board);
+
+    const auto rocks_static = measure(frames, [&]() -> uint32_t {
+        renderer.beginFrame();
+        renderer.setView(sf::View{board_area});
+        static_layer.draw(renderer, board_area);
+        renderer.endFrame();
+
+        return renderer.getStats().drawCalls;
+    });
+
+    std::println("entities: {}, frames: {}", entity_count, frames);
+    std::println("{:<18} {:>12} {:>14} {:>14}", "mode", "draw calls", "frame [ms]", "allocs/frame");
+    std::println("{:<18} {:>12} {:>14.3f} {:>14.2f}", "sprite per entity", per_entity.drawCalls, per_entity.avgFrameMs, per_entity.allocsPerFrame);
+    std::println("{:<18} {:>12} {:>14.3f} {:>14.2f}", "batched", batched.drawCalls, batched.avgFrameMs, batched.allocsPerFrame);
+
+    std::println("\nrocks: {}, board: {}x{}", board.getRocks().size(), side, side);
+    std::println("{:<18} {:>12} {:>14.3f} {:>14.2f}", "rocks batched", rocks_batched.drawCalls, rocks_batched.avgFrameMs, rocks_batched.allocsPerFrame);
+    std::println("{:<18} {:>12} {:>14.3f} {:>14.2f}", "static layer", rocks_static.drawCalls, rocks_static.avgFrameMs, rocks_static.allocsPerFrame);
+
+    return 0;
+}
@@ -0,0 +1,798 @@
+/**
+ * @file snek_bench.cpp
+ *
+ * @brief Self-contained microbenchmarks of the simulation hot paths.
+ *
+ * Every case is parameterized over snake length and/or board size and reports
+ * ns/op and heap allocations/op (counted by the replaced global operator new).
+ * Snakes are built straight down from the usual start position, on boards smaller
+ * than the snake the segments past the border are simply not on the grid.
+ *
+ * Finally checks that steady-state ticks allocate nothing, that a board rolled back to a
+ * saved state plays on exactly as before and that every collision kernel agrees with
+ * checkCollision(), exiting with 1 if any fails, and reports how many quick double turns
+ * the board's turn buffer keeps at each depth.
+ *
+ * Usage: snek_bench [--json <file>] [--filter <substring>] [--quick]
+ *
+ * @authors Jacek Zub
+ */
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <limits>
+#include <optional>
+#include <print>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "snek/Autopilot.hpp"
+#include "snek/Board.hpp"
+#include "snek/collision.hpp"
+#include "snek/Snake.hpp"
+
+#include "AllocationCounter.hpp"
+
+namespace snek {
+
+/**
+ * @brief Builds boards in benchmark shape and reaches into the private hot paths.
+ */
+struct BoardBenchAccess {
+    static auto make(uint32_t width, uint32_t height, uint32_t length) -> Board {
+        Board board{Board::Config{.width = width, .height = height, .seed = 1u}};
+
+        board.m_grid.clearSegments();
+        board.m_snake = Snake(length, {WINDOW_WIDTH / 2.f, WINDOW_HEIGHT / 2.f});
+        board.syncSnakeCells();
+
+        return board;
+    }
+
+    static auto handleCollision(Board& board) -> void {
+        board.handle_collision();
+    }
+
+    static auto spawnFruit(Board& board) -> bool {
+        return board.spawnFruit();
+    }
+
+    static auto createRocks(Board& board, uint32_t count) -> uint32_t {
+        return board.createRocks(count);
+    }
+};
+
+} // namespace snek
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Params = std::vector<std::pair<std::string_view, uint32_t>>;
+
+volatile size_t g_sink = 0u;
+
+struct Options {
+    std::string jsonPath;
+    std::string filter;
+    bool quick{false};
+};
+
+struct Result {
+    std::string name;
+    Params params;
+    uint64_t ops;
+    double nsPerOp;
+    double allocsPerOp;
+};
+
+class Runner {
+public:
+    explicit Runner(const Options& options)
+        : m_options(options)
+        , m_min_time(options.quick ? 0.02 : 0.2)
+    {}
+
+    /**
+     * @brief Times batches of op(state) until enough time was measured.
+     *
+     * @param fresh_each_batch Restore state from the prototype before every batch
+     *                         (untimed), for ops that accumulate state.
+     */
+    template<typename State, typename Op>
+    auto run(
+        std::string_view name,
+        Params params,
+        const State& prototype,
+        uint32_t batch,
+        bool fresh_each_batch,
+        Op&& op
+    ) -> const Result* {
+        if (!m_options.filter.empty() && name.find(m_options.filter) == std::string_view::npos) {
+            return nullptr;
+        }
+
+        State state = prototype;
+        op(state); // warm-up
+
+        uint64_t ops = 0u;
+        uint64_t allocations = 0u;
+        double seconds = 0.0;
+
+        const auto wall_start = Clock::now();
+        const double max_wall = m_min_time * 20.0;
+
+        while (seconds < m_min_time &&
+               std::chrono::duration<double>(Clock::now() - wall_start).count() < max_wall) {
+            if (fresh_each_batch) {
+                state = prototype;
+            }
+
+            const auto allocations_before = snek::bench::allocationCount();
+            const auto start = Clock::now();
+
+            for (uint32_t i = 0u; i < batch; i++) {
+                op(state);
+            }
+
+            seconds += std::chrono::duration<double>(Clock::now() - start).count();
+            allocations += snek::bench::allocationCount() - allocations_before;
+            ops += batch;
+        }
+
+        Result result{
+            std::string(name),
+            std::move(params),
+            ops,
+            seconds * 1e9 / static_cast<double>(ops),
+            static_cast<double>(allocations) / static_cast<double>(ops)
+        };
+
+        print(result);
+        m_results.push_back(std::move(result));
+
+        return &m_results.back();
+    }
+
+    auto writeJson(const std::string& path) const -> bool {
+        std::FILE* file = std::fopen(path.c_str(), "w");
+        if (file == nullptr) {
+            std::println(stderr, "Failed to open {}", path);
+
+            return false;
+        }
+
+        std::println(file, "{{\"benchmarks\": [");
+
+        for (size_t i = 0u; i < m_results.size(); i++) {
+            const auto& result = m_results[i];
+
+            std::print(file, "  {{\"name\": \"{}\", \"params\": {{", result.name);
+            for (size_t p = 0u; p < result.params.size(); p++) {
+                std::print(file, "{}\"{}\": {}", p == 0u ? "" : ", ", result.params[p].first, result.params[p].second);
+            }
+            std::println(file, "}}, \"ops\": {}, \"ns_per_op\": {:.3f}, \"allocs_per_op\": {:.4f}}}{}",
+                result.ops, result.nsPerOp, result.allocsPerOp, i + 1u < m_results.size() ? "," : "");
+        }
+
+        std::println(file, "]}}");
+        std::fclose(file);
+
+        return true;
+    }
+private:
+    static auto print(const Result& result) -> void {
+        std::string params;
+        for (const auto& [key, value] : result.params) {
+            params += std::string(key) + "=" + std::to_string(value) + " ";
+        }
+
+        std::println("{:<26} {:<34} {:>14.1f} ns/op {:>10.3f} allocs/op",
+            result.name, params, result.nsPerOp, result.allocsPerOp);
+    }
+
+    const Options& m_options;
+    double m_min_time;
+    std::vector<Result> m_results;
+};
+
+auto parseOptions(int argc, char** argv) -> Options {
+    Options options;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string_view arg{argv[i]};
+
+        if (arg == "--json" && i + 1 < argc) {
+            options.jsonPath = argv[++i];
+        } else if (arg == "--filter" && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (arg == "--quick") {
+            options.quick = true;
+        } else {
+            std::println(stderr, "Unknown argument: {}", arg);
+            std::println(stderr, "Usage: snek_bench [--json <file>] [--filter <substring>] [--quick]");
+            std::exit(1);
+        }
+    }
+
+    return options;
+}
+
+struct BoardSize {
+    uint32_t width;
+    uint32_t height;
+};
+
+constexpr float TICK = 1.f / snek::SIMULATION_TICK_RATE;
+
+auto benchSnake(Runner& runner, const std::vector<uint32_t>& lengths) -> void {
+    using snek::Snake;
+
+    const sf::Vector2f start{snek::WINDOW_WIDTH / 2.f, snek::WINDOW_HEIGHT / 2.f};
+
+    for (const auto length : lengths) {
+        const Params params{{"length", length}};
+
+        const Snake free_snake(length, start, Snake::Movement::Free);
+        const Snake grid_snake(length, start, Snake::Movement::Grid);
+
+        runner.run("Snake::move", params, free_snake, 64u, false, [](Snake& snake) {
+            snake.move(TICK);
+        });
+
+        runner.run("Snake::move[grid]", params, grid_snake, 1024u, false, [](Snake& snake) {
+            snake.move(TICK);
+        });
+
+        runner.run("Snake::turn", params, free_snake, 256u, true, [](Snake& snake) {
+            snake.m_distance_since_last_turn = snek::TILE_SIZE; // skip the one-turn-per-tile gate
+            snake.turnLeft();
+        });
+
+        runner.run("Snake::grow", params, free_snake, 256u, true, [](Snake& snake) {
+            snake.grow();
+        });
+    }
+}
+
+auto benchBoard(Runner& runner, const std::vector<uint32_t>& lengths, const std::vector<BoardSize>& sizes) -> void {
+    using snek::Board;
+    using snek::BoardBenchAccess;
+
+    for (const auto& [width, height] : sizes) {
+        for (const auto length : lengths) {
+            const Params params{{"width", width}, {"height", height}, {"length", length}};
+            const Board board = BoardBenchAccess::make(width, height, length);
+
+            runner.run("Board::handle_collision", params, board, 256u, false, [](Board& b) {
+                BoardBenchAccess::handleCollision(b);
+            });
+
+            runner.run("Board::forEachEntity", params, board, 16u, false, [](Board& b) {
+                b.forEachEntity([](const snek::Entity& entity) {
+                    g_sink = g_sink + static_cast<uint32_t>(entity.sprite);
+                });
+            });
+
+            runner.run("Board::spawnFruit", params, board, 64u, true, [](Board& b) {
+                g_sink = g_sink + BoardBenchAccess::spawnFruit(b);
+            });
+
+            runner.run("Board::createRocks", params, board, 8u, true, [](Board& b) {
+                g_sink = g_sink + BoardBenchAccess::createRocks(b, 10u);
+            });
+        }
+    }
+}
+
+/**
+ * @brief What a frame visits: every entity versus the camera's view, on boards at the default rock density.
+ *
+ * The culled walk should stay flat as the board grows, the full walk grows with it.
+ */
+auto benchCulling(Runner& runner, const std::vector<BoardSize>& sizes) -> void {
+    using snek::Board;
+
+    for (const auto& [width, height] : sizes) {
+        const uint32_t rocks = width * height / snek::BOARD_TILES_PER_ROCK;
+        const Params params{{"width", width}, {"height", height}, {"rocks", rocks}};
+        const Board board{Board::Config{.width = width, .height = height, .rocks = rocks, .seed = 1u}};
+
+        runner.run("Board::forEachEntity", params, board, 1u, false, [](Board& b) {
+            b.forEachEntity([](const snek::Entity& entity) {
+                g_sink = g_sink + static_cast<uint32_t>(entity.sprite);
+            });
+        });
+
+        runner.run("Board::forEachEntityIn", params, board, 64u, false, [](Board& b) {
+            b.forEachEntityIn(b.getCamera().getViewRect(), [](const snek::Entity& entity) {
+                g_sink = g_sink + static_cast<uint32_t>(entity.sprite);
+            });
+        });
+    }
+}
+
+struct StateBench {
+    snek::Board board;
+    std::vector<uint8_t> state;
+};
+
+struct CopyBench {
+    snek::Board board;
+    snek::Board copy;
+};
+
+/**
+ * @brief Checkpointing a board: saving and restoring its flat state, next to a plain copy of it.
+ *
+ * Restoring into the board the state came from skips the rocks, which never change.
+ */
+auto benchState(Runner& runner, const std::vector<uint32_t>& lengths, const std::vector<BoardSize>& sizes) -> void {
+    using snek::Board;
+
+    const auto bench = [&](Params params, const Board& board) {
+        const uint32_t batch = board.getWidth() * board.getHeight() > 1'000'000u ? 1u : 16u;
+
+        StateBench prototype{board, {}};
+        prototype.board.saveState(prototype.state);
+        params.emplace_back("bytes", static_cast<uint32_t>(prototype.state.size()));
+
+        runner.run("Board::saveState", params, prototype, batch, false, [](StateBench& s) {
+            s.board.saveState(s.state);
+            g_sink = g_sink + s.state.size();
+        });
+
+        runner.run("Board::restoreState", params, prototype, batch, false, [](StateBench& s) {
+            g_sink = g_sink + s.board.restoreState(s.state);
+        });
+
+        runner.run("Board copy", params, CopyBench{board, board}, batch, false, [](CopyBench& c) {
+            c.copy = c.board;
+            g_sink = g_sink + c.copy.getSnake().getLength();
+        });
+    };
+
+    for (const auto& [width, height] : sizes) {
+        for (const auto length : lengths) {
+            bench({{"width", width}, {"height", height}, {"length", length}},
+                snek::BoardBenchAccess::make(width, height, length));
+        }
+    }
+
+    // A board in play, arena snakes and fruits included
+    constexpr uint32_t ARENA_SNAKES = 50u;
+
+    Board arena{Board::Config{.width = 200u, .height = 150u, .arenaSnakes = ARENA_SNAKES, .seed = 1u}};
+    for (uint32_t i = 0u; i < 300u; i++) {
+        arena.update(snek::InputAction::None);
+    }
+
+    bench({{"width", 200u}, {"height", 150u}, {"arena", ARENA_SNAKES}}, arena);
+}
+
+constexpr std::array COLLISION_KERNELS = {
+    snek::CollisionKernel::Scalar,
+    snek::CollisionKernel::Sse,
+    snek::CollisionKernel::Avx,
+};
+
+struct RectColumns {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> width;
+    std::vector<float> height;
+
+    auto push(const sf::FloatRect& rect) -> void {
+        x.push_back(rect.position.x);
+        y.push_back(rect.position.y);
+        width.push_back(rect.size.x);
+        height.push_back(rect.size.y);
+    }
+
+    auto arrays() const -> snek::RectArrays {
+        return {x, y, width, height};
+    }
+};
+
+/**
+ * @brief Tile-sized rectangles scattered over a square about as wide as their count, the
+ *        tested one is a shrunk head in the middle, so a few of them collide.
+ */
+auto scatteredRects(uint32_t count) -> RectColumns {
+    std::mt19937 rng{1u};
+    const float side = std::sqrt(static_cast<float>(count)) * snek::TILE_SIZE;
+    std::uniform_real_distribution<float> coordinate{0.f, side};
+
+    RectColumns rects;
+    for (uint32_t i = 0u; i < count; i++) {
+        rects.push({{coordinate(rng), coordinate(rng)}, {snek::TILE_SIZE, snek::TILE_SIZE}});
+    }
+
+    return rects;
+}
+
+struct CollideState {
+    RectColumns rects;
+    std::vector<uint8_t> hits;
+    sf::FloatRect head;
+};
+
+/**
+ * @brief One rectangle against many: the pair test in a loop versus every batch kernel this CPU runs.
+ */
+auto benchCollision(Runner& runner, const std::vector<uint32_t>& counts) -> void {
+    for (const auto count : counts) {
+        const Params params{{"rects", count}};
+
+        auto rects = scatteredRects(count);
+        const float middle = std::sqrt(static_cast<float>(count)) * snek::TILE_SIZE / 2.f;
+        const CollideState prototype{std::move(rects), std::vector<uint8_t>(count), {{middle, middle}, {12.f, 12.f}}};
+        const uint32_t batch = std::max(1u, 65'536u / count);
+
+        const auto report = [&](const Result* result) {
+            if (result != nullptr) {
+                std::println("{:<26} {:.0f} M rects/s", "", static_cast<double>(count) * 1e3 / result->nsPerOp);
+            }
+        };
+
+        report(runner.run("checkCollision loop", params, prototype, batch, false, [](CollideState& s) {
+            uint32_t hits = 0u;
+            for (size_t i = 0u; i < s.rects.x.size(); i++) {
+                hits += snek::checkCollision(s.head, {{s.rects.x[i], s.rects.y[i]}, {s.rects.width[i], s.rects.height[i]}});
+            }
+
+            g_sink = g_sink + hits;
+        }));
+
+        for (const auto kernel : COLLISION_KERNELS) {
+            if (!snek::isSupported(kernel)) {
+                continue;
+            }
+
+            const auto name = kernel == snek::CollisionKernel::Avx ? "collideMany[avx]"
+                : kernel == snek::CollisionKernel::Sse ? "collideMany[sse]"
+                : "collideMany[scalar]";
+            report(runner.run(name, params, prototype, batch, false, [kernel](CollideState& s) {
+                g_sink = g_sink + snek::collideMany(s.head, s.rects.arrays(), s.hits, kernel);
+            }));
+        }
+    }
+}
+
+/**
+ * @brief Every supported kernel against checkCollision() on random rectangles and edge cases:
+ *        touching edges, empty and negative sizes, infinities and NaNs, at every batch offset.
+ */
+auto collisionKernelsMatch() -> bool {
+    constexpr float INF = std::numeric_limits<float>::infinity();
+    constexpr float NAN_VALUE = std::numeric_limits<float>::quiet_NaN();
+
+    const std::array special = {0.f, -0.f, 10.f, 20.f, 30.f, 9.999999f, 20.000002f, -5.f, INF, -INF, NAN_VALUE};
+    const sf::FloatRect a{{10.f, 10.f}, {10.f, 10.f}};
+
+    std::mt19937 rng{7u};
+    std::uniform_int_distribution<size_t> pick{0u, special.size() - 1u};
+    std::uniform_real_distribution<float> coordinate{-10.f, 40.f};
+
+    RectColumns rects;
+    for (uint32_t i = 0u; i < 4'000u; i++) {
+        if (i % 2u == 0u) {
+            rects.push({{special[pick(rng)], special[pick(rng)]}, {special[pick(rng)], special[pick(rng)]}});
+        } else {
+            rects.push({{coordinate(rng), coordinate(rng)}, {coordinate(rng) / 2.f, coordinate(rng) / 2.f}});
+        }
+    }
+
+    std::vector<uint8_t> hits(rects.x.size());
+
+    for (const auto kernel : COLLISION_KERNELS) {
+        if (!snek::isSupported(kernel)) {
+            continue;
+        }
+
+        // Every start offset and a ragged end, so each tail length runs through the scalar loop
+        for (size_t first = 0u; first < 9u; first++) {
+            const auto arrays = rects.arrays();
+            const auto size = arrays.size() - first - first % 3u;
+            const snek::RectArrays part{
+                arrays.x.subspan(first, size), arrays.y.subspan(first, size),
+                arrays.width.subspan(first, size), arrays.height.subspan(first, size)};
+
+            uint32_t expected_count = 0u;
+            const auto count = snek::collideMany(a, part, hits, kernel);
+
+            for (size_t i = 0u; i < size; i++) {
+                const bool expected = snek::checkCollision(a, {{part.x[i], part.y[i]}, {part.width[i], part.height[i]}});
+                expected_count += expected;
+
+                if (hits[i] != expected) {
+                    return false;
+                }
+            }
+
+            if (count != expected_count) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+struct PlanState {
+    snek::Board board;
+    snek::Autopilot autopilot;
+};
+
+/**
+ * @brief Path queries from the head to the fruit, on boards in benchmark shape.
+ *
+ * The straight snake walls off part of the board, long ones cut it in two, so paths
+ * to fruits on the far side have to go around the whole body.
+ */
+auto benchAutopilot(Runner& runner, const std::vector<uint32_t>& lengths, const std::vector<BoardSize>& sizes) -> void {
+    using snek::Autopilot;
+
+    for (const auto& [width, height] : sizes) {
+        for (const auto length : lengths) {
+            const Params params{{"width", width}, {"height", height}, {"length", length}};
+            const uint32_t batch = width * height > 1'000'000u ? 1u : 64u;
+
+            for (const auto search : {Autopilot::Search::AStar, Autopilot::Search::BreadthFirst}) {
+                const PlanState prototype{
+                    snek::BoardBenchAccess::make(width, height, length),
+                    Autopilot{Autopilot::Config{.search = search}}
+                };
+
+                const auto name = search == Autopilot::Search::AStar ? "Autopilot::plan[astar]" : "Autopilot::plan[bfs]";
+                const auto* result = runner.run(name, params, prototype, batch, false, [](PlanState& state) {
+                    g_sink = g_sink + state.autopilot.plan(state.board) + state.autopilot.getPath().size();
+                });
+
+                if (result != nullptr) {
+                    std::println("{:<26} {:.0f} queries/s", "", 1e9 / result->nsPerOp);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Allocations over many steady-state ticks, each followed by the culled entity walk a frame does.
+ *
+ * The snake turns left every 4 tiles, circling on a big board forever. Warm-up ticks
+ * let the pivot ring, cell ring and entity buffers reach their final capacity first.
+ *
+ * @return Allocations counted, or nullopt if the snake didn't survive.
+ */
+auto steadyStateAllocations(snek::Snake::Movement movement) -> std::optional<uint64_t> {
+    using snek::Board;
+
+    constexpr uint32_t WARM_UP_TICKS = 600u;
+    constexpr uint32_t MEASURED_TICKS = 10'000u;
+    constexpr uint32_t TICKS_PER_SIDE = 60u;
+
+    Board board{Board::Config{.width = 2000u, .height = 2000u, .movement = movement, .seed = 1u}};
+
+    const auto tick = [&](uint32_t i) {
+        board.update(i % TICKS_PER_SIDE == 0u ? snek::InputAction::TurnLeft : snek::InputAction::None);
+
+        board.forEachEntityIn(board.getCamera().getViewRect(), [](const snek::Entity& entity) {
+            g_sink = g_sink + static_cast<uint32_t>(entity.sprite);
+        });
+    };
+
+    for (uint32_t i = 0u; i < WARM_UP_TICKS; i++) {
+        tick(i);
+    }
+
+    const auto before = snek::bench::allocationCount();
+
+    for (uint32_t i = WARM_UP_TICKS; i < WARM_UP_TICKS + MEASURED_TICKS; i++) {
+        tick(i);
+    }
+
+    const auto allocations = snek::bench::allocationCount() - before;
+
+    if (board.getState() != Board::State::Playing) {
+        return std::nullopt;
+    }
+
+    return allocations;
+}
+
+/**
+ * @brief Saves a board mid-game, plays on, rolls back and plays the same inputs again.
+ *
+ * Both runs must end in byte for byte the same state, many times over from one save.
+ *
+ * @return Whether every replayed run matched.
+ */
+auto rollbackMatches(snek::Snake::Movement movement) -> bool {
+    using snek::Board;
+
+    constexpr uint32_t ROLLBACKS = 20u;
+    constexpr uint32_t TICKS_PER_ROLLBACK = 120u;
+    constexpr uint32_t TICKS_PER_SIDE = 45u;
+
+    Board board{Board::Config{.width = 200u, .height = 150u, .arenaSnakes = 20u, .movement = movement, .seed = 1u}};
+    for (uint32_t i = 0u; i < 300u; i++) {
+        board.update(i % TICKS_PER_SIDE == 0u ? snek::InputAction::TurnLeft : snek::InputAction::None);
+    }
+
+    std::vector<uint8_t> checkpoint;
+    std::vector<uint8_t> expected;
+    std::vector<uint8_t> actual;
+    board.saveState(checkpoint);
+
+    const auto play = [&] {
+        for (uint32_t i = 0u; i < TICKS_PER_ROLLBACK; i++) {
+            board.update(i % TICKS_PER_SIDE == 0u ? snek::InputAction::TurnRight : snek::InputAction::None);
+        }
+    };
+
+    play();
+    board.saveState(expected);
+
+    for (uint32_t i = 0u; i < ROLLBACKS; i++) {
+        if (!board.restoreState(checkpoint)) {
+            return false;
+        }
+
+        play();
+        board.saveState(actual);
+
+        if (actual != expected) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+struct TurnBufferResult {
+    uint64_t fed;
+    uint64_t taken;
+    uint64_t dropped;
+    double avgTicks;  // from being fed to update() to being taken
+    uint64_t maxTicks;
+};
+
+/**
+ * @brief Feeds U-turns (two turns on consecutive ticks) once a second and times them in ticks.
+ *
+ * The snake travels a tile between turns, so the second turn of each pair can only be
+ * taken some ticks later, or not at all without a buffer. Pairs alternate left and right,
+ * the snake zigzags away from its own body.
+ */
+auto turnBufferResult(uint32_t depth) -> TurnBufferResult {
+    using snek::Board;
+    using snek::InputAction;
+
+    constexpr uint32_t U_TURNS = 100u;
+    constexpr uint32_t TICKS_PER_U_TURN = 60u;
+
+    Board board{Board::Config{.width = 2000u, .height = 2000u, .rocks = 0u, .turnBuffer = depth, .seed = 1u}};
+
+    std::deque<uint64_t> waiting; // ticks the not yet taken turns were fed on
+    TurnBufferResult result{};
+    uint64_t total_ticks = 0u;
+
+    for (uint64_t tick = 0u; tick < U_TURNS * TICKS_PER_U_TURN && board.getState() == Board::State::Playing; tick++) {
+        const uint64_t phase = tick % TICKS_PER_U_TURN;
+        const auto turn = (tick / TICKS_PER_U_TURN) % 2u == 0u ? InputAction::TurnLeft : InputAction::TurnRight;
+        const auto action = phase < 2u ? turn : InputAction::None;
+
+        const auto dropped = board.getTurnsDropped();
+        const auto taken = board.getTurnsTaken();
+
+        board.update(action);
+
+        if (action != InputAction::None) {
+            result.fed++;
+
+            if (board.getTurnsDropped() == dropped) {
+                waiting.push_back(tick);
+            }
+        }
+
+        for (auto i = taken; i < board.getTurnsTaken(); i++) {
+            const uint64_t ticks = tick - waiting.front();
+            waiting.pop_front();
+
+            total_ticks += ticks;
+            result.maxTicks = std::max(result.maxTicks, ticks);
+        }
+    }
+
+    result.taken = board.getTurnsTaken();
+    result.dropped = board.getTurnsDropped();
+    result.avgTicks = result.taken == 0u ? 0.0 : static_cast<double>(total_ticks) / static_cast<double>(result.taken);
+
+    return result;
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int32_t {
+    const auto options = parseOptions(argc, argv);
+
+    const std::vector<uint32_t> lengths = options.quick
+        ? std::vector<uint32_t>{10u, 1'000u, 100'000u}
+        : std::vector<uint32_t>{10u, 100u, 1'000u, 10'000u, 100'000u};
+
+    const std::vector<BoardSize> sizes = options.quick
+        ? std::vector<BoardSize>{{40u, 30u}, {2000u, 2000u}}
+        : std::vector<BoardSize>{{40u, 30u}, {200u, 150u}, {1000u, 1000u}, {2000u, 2000u}};
+
+    Runner runner{options};
+
+    benchSnake(runner, lengths);
+    benchBoard(runner, lengths, sizes);
+
+    const std::vector<BoardSize> world_sizes = options.quick
+        ? std::vector<BoardSize>{{40u, 30u}, {2000u, 2000u}}
+        : std::vector<BoardSize>{{40u, 30u}, {1000u, 1000u}, {10'000u, 10'000u}};
+
+    benchCulling(runner, world_sizes);
+    benchAutopilot(runner, lengths, world_sizes);
+    benchState(runner, lengths, sizes);
+
+    std::println("collision kernel: {}", snek::getName(snek::bestCollisionKernel()));
+    benchCollision(runner, options.quick
+        ? std::vector<uint32_t>{16u, 100'000u}
+        : std::vector<uint32_t>{16u, 1'000u, 100'000u, 1'000'000u});
+
+    if (!options.jsonPath.empty() && !runner.writeJson(options.jsonPath)) {
+        return 1;
+    }
+
+    // Not a timing, a check: a steady-state tick and frame must not touch the heap
+    bool steady = true;
+    for (const auto movement : {snek::Snake::Movement::Free, snek::Snake::Movement::Grid}) {
+        const auto name = movement == snek::Snake::Movement::Free ? "free" : "grid";
+        const auto allocations = steadyStateAllocations(movement);
+
+        if (!allocations) {
+            std::println(stderr, "steady state [{}]: the snake died, the check is invalid", name);
+        } else {
+            std::println("steady state [{}]: {} allocations over 10000 ticks", name, *allocations);
+        }
+
+        steady = steady && allocations == 0u;
+    }
+
+    // Neither: a board rolled back to a saved state must play on exactly as before
+    bool rolled_back = true;
+    for (const auto movement : {snek::Snake::Movement::Free, snek::Snake::Movement::Grid}) {
+        const auto name = movement == snek::Snake::Movement::Free ? "free" : "grid";
+        const bool matches = rollbackMatches(movement);
+
+        std::println("rollback [{}]: {}", name, matches ? "replayed states match" : "replayed states differ");
+
+        rolled_back = rolled_back && matches;
+    }
+
+    const bool kernels_match = collisionKernelsMatch();
+    std::println("collision kernels: {}", kernels_match ? "match checkCollision" : "differ from checkCollision");
+
+    for (const uint32_t depth : {0u, 1u, snek::INPUT_TURN_BUFFER_DEPTH}) {
+        const auto result = turnBufferResult(depth);
+
+        std::println("turn buffer [depth {}]: {} of {} turns taken, {} dropped, {:.1f} ticks avg, {} max from input to turn",
+            depth, result.taken, result.fed, result.dropped, result.avgTicks, result.maxTicks);
+    }
+
+    if (!steady || !rolled_back || !kernels_match) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file Arguments.hpp
+ *
+ * @brief Strict parsing of the positional arguments the command line tools share.
+ *
+ * A value that doesn't parse is reported on stderr instead of read as 0, so a typo
+ * never quietly runs something else.
+ *
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <charconv>
+#include <concepts>
+#include <limits>
+#include <optional>
+#include <print>
+#include <span>
+#include <string_view>
+#include <system_error>
+
+#include "snek/Snake.hpp"
+
+namespace snek {
+
+/**
+ * @brief A whole decimal number that fits T, nullopt for anything else (signs, spaces, trailing text).
+ */
+template<std::unsigned_integral T>
+auto parseNumber(std::string_view text) -> std::optional<T> {
+    T value{};
+    const auto end = text.data() + text.size();
+    const auto [ptr, error] = std::from_chars(text.data(), end, value);
+
+    if (error != std::errc{} || ptr != end) {
+        return std::nullopt;
+    }
+
+    return value;
+}
+
+/**
+ * @brief The index-th positional argument as a number, fallback when there are fewer.
+ *
+ * @return nullopt after printing why when the argument isn't a number fitting T.
+ */
+template<std::unsigned_integral T>
+auto positionalNumber(std::span<const std::string_view> positional, size_t index, std::string_view name, T fallback)
+    -> std::optional<T> {
+    if (index >= positional.size()) {
+        return fallback;
+    }
+
+    const auto value = parseNumber<T>(positional[index]);
+    if (!value) {
+        std::println(stderr, "Invalid {} {}, expected a number up to {}", name, positional[index], std::numeric_limits<T>::max());
+    }
+
+    return value;
+}
+
+/**
+ * @brief The index-th positional argument as "free" or "grid" movement, Free when there are fewer.
+ *
+ * @return nullopt after printing why when the argument is neither.
+ */
+inline auto positionalMovement(std::span<const std::string_view> positional, size_t index) -> std::optional<Snake::Movement> {
+    if (index >= positional.size() || positional[index] == "free") {
+        return Snake::Movement::Free;
+    }
+
+    if (positional[index] == "grid") {
+        return Snake::Movement::Grid;
+    }
+
+    std::println(stderr, "Invalid movement {}, expected free or grid", positional[index]);
+
+    return std::nullopt;
+}
+
+/**
+ * @brief Whether a tool taking up to max positional arguments got no more, prints the first extra one otherwise.
+ */
+inline auto checkPositionalCount(std::span<const std::string_view> positional, size_t max) -> bool {
+    if (positional.size() > max) {
+        std::println(stderr, "Unexpected argument {}", positional[max]);
+
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace snek
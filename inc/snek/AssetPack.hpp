@@ -0,0 +1,345 @@
+/**
+ * @file AssetPack.hpp
+ *
+ * @brief Single-file asset pack, memory-mapped at runtime so assets load straight from memory.
+ *
+ * File layout, little-endian:
+ *   header  "SNKP", version u32, entryCount u32
+ *   entries entryCount x (pathLength u16, path bytes, offset u64, size u64)
+ *   data    every asset's bytes at its offset, 16 byte aligned
+ *
+ * Paths are stored exactly as the game asks for them (e.g. "res/arial.ttf"), so mounting
+ * a pack is transparent to the rest of the code. Packs are built offline by snek_pack.
+ *
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <print>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "snek/ByteStream.hpp"
+
+namespace snek {
+
+/**
+ * @brief Read-only view of a whole file mapped into memory, unmapped on destruction.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    MappedFile(MappedFile&& other) noexcept
+        : m_data(std::exchange(other.m_data, nullptr))
+        , m_size(std::exchange(other.m_size, 0u))
+    {}
+
+    auto operator=(MappedFile&& other) noexcept -> MappedFile& {
+        if (this != &other) {
+            unmap();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0u);
+        }
+
+        return *this;
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    auto operator=(const MappedFile&) -> MappedFile& = delete;
+
+    ~MappedFile() {
+        unmap();
+    }
+
+    static auto open(std::string_view path) -> std::optional<MappedFile> {
+        MappedFile file;
+        const std::string path_str{path};
+
+#ifdef _WIN32
+        const HANDLE handle = CreateFileA(path_str.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) {
+            return std::nullopt;
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(handle, &size) || size.QuadPart == 0) {
+            CloseHandle(handle);
+
+            return std::nullopt;
+        }
+
+        const HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(handle);
+        if (mapping == nullptr) {
+            return std::nullopt;
+        }
+
+        void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping); // the view keeps the mapping alive
+        if (data == nullptr) {
+            return std::nullopt;
+        }
+
+        file.m_data = static_cast<const std::byte*>(data);
+        file.m_size = static_cast<size_t>(size.QuadPart);
+#else
+        const int fd = ::open(path_str.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return std::nullopt;
+        }
+
+        struct stat info{};
+        if (::fstat(fd, &info) != 0 || info.st_size == 0) {
+            ::close(fd);
+
+            return std::nullopt;
+        }
+
+        void* data = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // the mapping keeps the file alive
+        if (data == MAP_FAILED) {
+            return std::nullopt;
+        }
+
+        file.m_data = static_cast<const std::byte*>(data);
+        file.m_size = static_cast<size_t>(info.st_size);
+#endif
+
+        return file;
+    }
+
+    auto bytes() const -> std::span<const std::byte> {
+        return {m_data, m_size};
+    }
+private:
+    auto unmap() -> void {
+        if (m_data == nullptr) {
+            return;
+        }
+
+#ifdef _WIN32
+        UnmapViewOfFile(m_data);
+#else
+        ::munmap(const_cast<std::byte*>(m_data), m_size);
+#endif
+
+        m_data = nullptr;
+        m_size = 0u;
+    }
+
+    const std::byte* m_data{nullptr};
+    size_t m_size{0u};
+}; // class MappedFile
+
+class AssetPack {
+public:
+    static constexpr uint32_t VERSION = 1u;
+    static constexpr size_t DATA_ALIGNMENT = 16u;
+
+    struct Source {
+        std::string path;
+        std::vector<uint8_t> bytes;
+    };
+
+    /**
+     * @brief Serializes the given assets into the pack format, used by the offline packer.
+     */
+    static auto build(const std::vector<Source>& sources) -> ByteWriter {
+        ByteWriter writer;
+
+        // The table size is known up front, so offsets can be assigned in one pass
+        size_t offset = 4u + 4u + 4u;
+        for (const auto& source : sources) {
+            offset += 2u + source.path.size() + 8u + 8u;
+        }
+
+        writer.putBytes(MAGIC);
+        writer.put(VERSION);
+        writer.put(static_cast<uint32_t>(sources.size()));
+
+        std::vector<size_t> offsets;
+        for (const auto& source : sources) {
+            offset = alignUp(offset);
+            offsets.push_back(offset);
+
+            writer.put(static_cast<uint16_t>(source.path.size()));
+            writer.putBytes({reinterpret_cast<const uint8_t*>(source.path.data()), source.path.size()});
+            writer.put(static_cast<uint64_t>(offset));
+            writer.put(static_cast<uint64_t>(source.bytes.size()));
+
+            offset += source.bytes.size();
+        }
+
+        for (size_t i = 0u; i < sources.size(); i++) {
+            while (writer.getBytes().size() < offsets[i]) {
+                writer.put(uint8_t{0u});
+            }
+
+            writer.putBytes(sources[i].bytes);
+        }
+
+        return writer;
+    }
+
+    static auto open(std::string_view path) -> std::optional<AssetPack> {
+        auto file = MappedFile::open(path);
+        if (!file) {
+            std::println(stderr, "Failed to map asset pack {}", path);
+
+            return std::nullopt;
+        }
+
+        AssetPack pack;
+        pack.m_file = std::move(*file);
+
+        const auto bytes = pack.m_file.bytes();
+        const std::span<const uint8_t> raw{reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size()};
+
+        ByteReader reader{raw};
+
+        bool valid = true;
+        for (const auto byte : MAGIC) {
+            valid = valid && reader.get<uint8_t>() == byte;
+        }
+        valid = valid && reader.get<uint32_t>() == VERSION;
+
+        const auto count = reader.get<uint32_t>();
+
+        for (uint32_t i = 0u; i < count && valid && !reader.failed(); i++) {
+            const auto path_length = reader.get<uint16_t>();
+            if (path_length > reader.remaining()) {
+                valid = false;
+                break;
+            }
+
+            const auto path_offset = raw.size() - reader.remaining();
+            for (uint16_t c = 0u; c < path_length; c++) {
+                (void)reader.get<uint8_t>();
+            }
+
+            Entry entry;
+            entry.path = {reinterpret_cast<const char*>(raw.data() + path_offset), path_length};
+            entry.offset = reader.get<uint64_t>();
+            entry.size = reader.get<uint64_t>();
+
+            valid = entry.offset <= raw.size() && entry.size <= raw.size() - entry.offset;
+
+            pack.m_entries.push_back(entry);
+        }
+
+        if (!valid || reader.failed()) {
+            std::println(stderr, "{} is not a valid snek asset pack of version {}", path, VERSION);
+
+            return std::nullopt;
+        }
+
+        return pack;
+    }
+
+    /**
+     * @brief Bytes of the asset stored under path, a view into the mapping.
+     */
+    auto find(std::string_view path) const -> std::optional<std::span<const std::byte>> {
+        for (const auto& entry : m_entries) {
+            if (entry.path == path) {
+                return m_file.bytes().subspan(entry.offset, entry.size);
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    auto getEntryCount() const -> size_t {
+        return m_entries.size();
+    }
+
+    /**
+     * @brief Makes the pack the source of every asset load, call once at startup.
+     *
+     * The pack stays mapped until exit, SFML resources may keep referring to its bytes.
+     */
+    static auto mount(std::string_view path) -> bool {
+        auto pack = open(path);
+        if (!pack) {
+            return false;
+        }
+
+        mounted().emplace(std::move(*pack));
+
+        return true;
+    }
+
+    /**
+     * @brief Bytes of an asset in the mounted pack, nullopt when there's none or it isn't packed.
+     */
+    static auto findMounted(std::string_view path) -> std::optional<std::span<const std::byte>> {
+        const auto& pack = mounted();
+
+        return pack ? pack->find(path) : std::nullopt;
+    }
+private:
+    static constexpr uint8_t MAGIC[4] = {'S', 'N', 'K', 'P'};
+
+    struct Entry {
+        std::string_view path; // points into the mapping
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    static auto alignUp(size_t offset) -> size_t {
+        return (offset + DATA_ALIGNMENT - 1u) & ~(DATA_ALIGNMENT - 1u);
+    }
+
+    static auto mounted() -> std::optional<AssetPack>& {
+        static std::optional<AssetPack> pack;
+        return pack;
+    }
+
+    MappedFile m_file;
+    std::vector<Entry> m_entries; // a handful of assets, a linear scan is fine
+}; // class AssetPack
+
+/**
+ * @brief Loads an SFML resource from the mounted pack if it has the asset, else from disk.
+ *
+ * Works for anything with loadFromMemory/loadFromFile (textures, images, sound buffers)
+ * or openFromMemory/openFromFile (fonts).
+ */
+template<typename Resource>
+auto loadAsset(Resource& resource, std::string_view path) -> bool {
+    if (const auto bytes = AssetPack::findMounted(path)) {
+        if constexpr (requires { resource.openFromMemory(bytes->data(), bytes->size()); }) {
+            return resource.openFromMemory(bytes->data(), bytes->size());
+        } else {
+            return resource.loadFromMemory(bytes->data(), bytes->size());
+        }
+    }
+
+    if constexpr (requires { resource.openFromFile(path); }) {
+        return resource.openFromFile(path);
+    } else {
+        return resource.loadFromFile(path);
+    }
+}
+
+} // namespace snek
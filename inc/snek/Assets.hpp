@@ -0,0 +1,187 @@
+/**
+ * @file Assets.hpp
+ *
+ * @brief Compile-time registry of every asset, addressed by typed integer handles.
+ *
+ * Each asset kind has an enum of handles and a constexpr table indexed by it, so a runtime
+ * lookup is an array index. Names resolve to handles at compile time via assetHandle<Id>(),
+ * an unknown name doesn't compile.
+ *
+ * Sprites are packed into one texture atlas. The layout is computed here at compile time,
+ * the snek_atlas tool composes the atlas image from the same layout.
+ *
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+#include "snek/constants.hpp"
+
+namespace snek {
+
+enum class TextureId : uint8_t {
+    Atlas,
+    Count
+};
+
+enum class FontId : uint8_t {
+    Ui,
+    Count
+};
+
+enum class SoundId : uint8_t {
+    MenuOption,
+    MenuConfirm,
+    Turn,
+    Eat,
+    Death,
+    Count
+};
+
+enum class SpriteId : uint8_t {
+    SnakeHead,
+    SnakeBody,
+    Fruit,
+    Rock,
+    Count
+};
+
+struct AssetInfo {
+    std::string_view name;
+    std::string_view path;
+};
+
+struct SpriteInfo {
+    std::string_view name;
+    std::string_view source; // image the sprite is cut from when building the atlas
+    sf::IntRect sourceRect;
+};
+
+// Tables are indexed by their handle enum, keep the order in sync (checked below)
+inline constexpr std::array<AssetInfo, static_cast<size_t>(TextureId::Count)> TEXTURE_ASSETS = {{
+    {"atlas", RESPATH_ATLAS_PNG},
+}};
+
+inline constexpr std::array<AssetInfo, static_cast<size_t>(FontId::Count)> FONT_ASSETS = {{
+    {"ui", RESPATH_ARIAL_TTF},
+}};
+
+inline constexpr std::array<AssetInfo, static_cast<size_t>(SoundId::Count)> SOUND_ASSETS = {{
+    {"menu_option",  RESPATH_OPTION_WAV},
+    {"menu_confirm", RESPATH_CONFIRM_WAV},
+    {"turn",         RESPATH_TURN_WAV},
+    {"eat",          RESPATH_EAT_WAV},
+    {"death",        RESPATH_DEATH_WAV},
+}};
+
+inline constexpr std::array<SpriteInfo, static_cast<size_t>(SpriteId::Count)> SPRITE_ASSETS = {{
+    {"snake_head", RESPATH_SNAKE_SPRITES_PNG, {{0 * TEXTURE_TILE_SIZE, 0}, {TEXTURE_TILE_SIZE, TEXTURE_TILE_SIZE}}},
+    {"snake_body", RESPATH_SNAKE_SPRITES_PNG, {{1 * TEXTURE_TILE_SIZE, 0}, {TEXTURE_TILE_SIZE, TEXTURE_TILE_SIZE}}},
+    {"fruit",      RESPATH_SNAKE_SPRITES_PNG, {{2 * TEXTURE_TILE_SIZE, 0}, {TEXTURE_TILE_SIZE, TEXTURE_TILE_SIZE}}},
+    {"rock",       RESPATH_SNAKE_SPRITES_PNG, {{3 * TEXTURE_TILE_SIZE, 0}, {TEXTURE_TILE_SIZE, TEXTURE_TILE_SIZE}}},
+}};
+
+template<typename Id>
+constexpr auto assetTable() -> const auto& {
+    if constexpr (std::is_same_v<Id, TextureId>) {
+        return TEXTURE_ASSETS;
+    } else if constexpr (std::is_same_v<Id, FontId>) {
+        return FONT_ASSETS;
+    } else if constexpr (std::is_same_v<Id, SoundId>) {
+        return SOUND_ASSETS;
+    } else {
+        static_assert(std::is_same_v<Id, SpriteId>, "not an asset handle type");
+        return SPRITE_ASSETS;
+    }
+}
+
+/**
+ * @brief Handle of the asset with the given name, resolved at compile time.
+ */
+template<typename Id>
+consteval auto assetHandle(std::string_view name) -> Id {
+    const auto& table = assetTable<Id>();
+
+    for (size_t i = 0u; i < table.size(); i++) {
+        if (table[i].name == name) {
+            return static_cast<Id>(i);
+        }
+    }
+
+    throw "unknown asset name"; // not a constant expression, fails the build
+}
+
+template<typename Id>
+constexpr auto assetPath(Id id) -> std::string_view {
+    return assetTable<Id>()[static_cast<size_t>(id)].path;
+}
+
+static_assert(assetHandle<TextureId>("atlas") == TextureId::Atlas);
+static_assert(assetHandle<FontId>("ui") == FontId::Ui);
+static_assert(assetHandle<SoundId>("menu_option") == SoundId::MenuOption);
+static_assert(assetHandle<SoundId>("menu_confirm") == SoundId::MenuConfirm);
+static_assert(assetHandle<SoundId>("turn") == SoundId::Turn);
+static_assert(assetHandle<SoundId>("eat") == SoundId::Eat);
+static_assert(assetHandle<SoundId>("death") == SoundId::Death);
+static_assert(assetHandle<SpriteId>("snake_head") == SpriteId::SnakeHead);
+static_assert(assetHandle<SpriteId>("snake_body") == SpriteId::SnakeBody);
+static_assert(assetHandle<SpriteId>("fruit") == SpriteId::Fruit);
+static_assert(assetHandle<SpriteId>("rock") == SpriteId::Rock);
+
+struct AtlasLayout {
+    std::array<sf::IntRect, static_cast<size_t>(SpriteId::Count)> rects;
+    sf::Vector2i size;
+};
+
+/**
+ * @brief Shelf-packs the sprites in table order into rows at most ATLAS_MAX_WIDTH wide.
+ */
+constexpr auto packAtlas() -> AtlasLayout {
+    constexpr int32_t ATLAS_MAX_WIDTH = 1024;
+
+    AtlasLayout layout{};
+
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t row_height = 0;
+
+    for (size_t i = 0u; i < SPRITE_ASSETS.size(); i++) {
+        const auto size = SPRITE_ASSETS[i].sourceRect.size;
+
+        if (x > 0 && x + size.x > ATLAS_MAX_WIDTH) {
+            y += row_height;
+            x = 0;
+            row_height = 0;
+        }
+
+        layout.rects[i] = {{x, y}, size};
+
+        x += size.x;
+        row_height = std::max(row_height, size.y);
+        layout.size.x = std::max(layout.size.x, x);
+    }
+
+    layout.size.y = y + row_height;
+
+    return layout;
+}
+
+inline constexpr AtlasLayout ATLAS_LAYOUT = packAtlas();
+
+/**
+ * @brief Texture rect of the sprite within the atlas, an array index.
+ */
+constexpr auto getSpriteRect(SpriteId sprite) -> sf::IntRect {
+    return ATLAS_LAYOUT.rects[static_cast<size_t>(sprite)];
+}
+
+} // namespace snek
@@ -0,0 +1,441 @@
+/**
+ * @file Autopilot.hpp
+ *
+ * @brief Bot steering the snake along a shortest path to the nearest fruit, for soak tests.
+ *
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "snek/Board.hpp"
+#include "snek/constants.hpp"
+#include "snek/Controller.hpp"
+#include "snek/OccupancyGrid.hpp"
+#include "snek/Profiler.hpp"
+
+namespace snek {
+
+/**
+ * @brief Plans on the board's cell grid, around rocks, the snake's body and the borders.
+ *
+ * A path is only planned again when it's invalidated: the snake left it, its next cell got
+ * blocked or its fruit is gone. When no path is found the snake keeps to free cells and
+ * the search is retried in the next cell.
+ *
+ * Search state lives in chunks mirroring the OccupancyGrid's, allocated where a search
+ * first reaches and reused by every later one (a stamp per search marks what's current),
+ * so searches on huge boards touch memory only around the path and don't allocate once
+ * warmed up.
+ */
+class Autopilot final : public IController {
+public:
+    enum class Search {
+        AStar,       // towards the fruit nearest as the crow flies, explores little
+        BreadthFirst // to the fruit nearest by path, explores everything closer
+    };
+
+    struct Config {
+        Search search{Search::AStar};
+        uint32_t maxExpansions{AUTOPILOT_MAX_EXPANSIONS}; // a search gives up after this many cells
+    };
+
+    Autopilot()
+        : Autopilot(Config{})
+    {}
+
+    explicit Autopilot(const Config& config)
+        : m_config(config)
+    {}
+
+    auto decide(const Board& board) -> InputAction override {
+        if (board.getState() != Board::State::Playing) {
+            return InputAction::None;
+        }
+
+        const auto head = headCell(board);
+        if (!head) {
+            return InputAction::None;
+        }
+
+        if (m_step < m_path.size() && m_path[m_step] == *head) {
+            m_step++;
+        }
+
+        if (!followsPath(board, *head) && *head != m_failed_cell) {
+            m_failed_cell = findPath(board, *head) ? NO_CELL : *head;
+        }
+
+        const auto direction = followsPath(board, *head)
+            ? std::optional{directionTo(board.getGrid(), *head, m_path[m_step])}
+            : safeDirection(board, *head);
+
+        if (!direction) {
+            return InputAction::None; // boxed in, nothing to do
+        }
+
+        return steer(board, *head, *direction);
+    }
+
+    /**
+     * @brief Searches a path from the snake's head to the nearest fruit right away.
+     *
+     * @return false when there's none (within maxExpansions).
+     */
+    auto plan(const Board& board) -> bool {
+        const auto head = headCell(board);
+
+        return head && findPath(board, *head);
+    }
+
+    /**
+     * @brief Cells of the current path still ahead, the fruit's last.
+     */
+    auto getPath() const -> std::span<const uint32_t> {
+        return std::span{m_path}.subspan(std::min(m_step, m_path.size()));
+    }
+
+    auto getSearchCount() const -> uint64_t {
+        return m_searches;
+    }
+
+    /**
+     * @brief Cells the last search expanded.
+     */
+    auto getLastExpansions() const -> uint32_t {
+        return m_expanded;
+    }
+private:
+    static constexpr uint32_t NO_CELL = UINT32_MAX;
+    static constexpr uint32_t NO_CHUNK = UINT32_MAX;
+
+    // Indexed by Direction
+    static constexpr std::array<sf::Vector2i, 4> DIRECTION_OFFSETS = {{{0, -1}, {1, 0}, {0, 1}, {-1, 0}}};
+
+    struct Node {
+        uint32_t stamp;  // search that last reached the cell
+        uint32_t parent; // cell it was reached from
+        uint32_t cost;   // steps from the start
+    };
+
+    struct OpenEntry {
+        uint64_t key; // f above, the inverted cost below: ties go to the deeper node
+        uint32_t cell;
+    };
+
+    auto findPath(const Board& board, uint32_t start) -> bool {
+        SNEK_PROFILE_SCOPE("Autopilot::findPath");
+
+        const auto& grid = board.getGrid();
+        const auto reverse = static_cast<Direction>((static_cast<int32_t>(board.getSnake().getHeading()) + 2) % 4);
+
+        beginSearch(grid);
+
+        m_path.clear();
+        m_step = 0u;
+        m_start = start;
+
+        const auto target = m_config.search == Search::AStar
+            ? searchAStar(board, start, reverse)
+            : searchBreadthFirst(grid, start, reverse);
+
+        if (!target) {
+            return false;
+        }
+
+        for (uint32_t cell = *target; cell != start; cell = nodeAt(cell).parent) {
+            m_path.push_back(cell);
+        }
+        std::ranges::reverse(m_path);
+
+        return true;
+    }
+
+    auto searchAStar(const Board& board, uint32_t start, Direction reverse) -> std::optional<uint32_t> {
+        const auto& grid = board.getGrid();
+        const auto origin = grid.cellCoords(start);
+
+        const auto distance = [](sf::Vector2u a, sf::Vector2u b) -> uint32_t {
+            return (a.x > b.x ? a.x - b.x : b.x - a.x) + (a.y > b.y ? a.y - b.y : b.y - a.y);
+        };
+
+        std::optional<uint32_t> target;
+        uint32_t target_distance = UINT32_MAX;
+
+        board.getFruits().forEach([&](const Entity& fruit) {
+            const auto cell = grid.cellAt(fruit.position);
+            if (cell && distance(origin, grid.cellCoords(*cell)) < target_distance) {
+                target = *cell;
+                target_distance = distance(origin, grid.cellCoords(*cell));
+            }
+        });
+
+        if (!target) {
+            return std::nullopt;
+        }
+
+        const auto goal = grid.cellCoords(*target);
+        const auto push = [&](uint32_t cell, uint32_t cost) {
+            const uint64_t f = cost + distance(grid.cellCoords(cell), goal);
+
+            m_open.push_back({f << 32u | (UINT32_MAX - cost), cell});
+            std::ranges::push_heap(m_open, std::greater{}, &OpenEntry::key);
+        };
+
+        m_open.clear();
+        nodeAt(start) = {m_stamp, start, 0u};
+        push(start, 0u);
+
+        while (!m_open.empty()) {
+            std::ranges::pop_heap(m_open, std::greater{}, &OpenEntry::key);
+            const auto entry = m_open.back();
+            const uint32_t cell = entry.cell;
+            m_open.pop_back();
+
+            const uint32_t cost = UINT32_MAX - static_cast<uint32_t>(entry.key);
+            if (cost > nodeAt(cell).cost) {
+                continue; // reached more cheaply since it was queued
+            }
+
+            if (cell == *target) {
+                return target;
+            }
+
+            if (++m_expanded > m_config.maxExpansions) {
+                return std::nullopt;
+            }
+
+            forEachNeighbour(grid, cell, [&](uint32_t next, Direction direction) {
+                if ((cell == start && direction == reverse) || isBlocked(grid, next)) {
+                    return;
+                }
+
+                auto& node = nodeAt(next);
+                if (node.stamp == m_stamp && node.cost <= cost + 1u) {
+                    return;
+                }
+
+                node = {m_stamp, cell, cost + 1u};
+                push(next, cost + 1u);
+            });
+        }
+
+        return std::nullopt;
+    }
+
+    auto searchBreadthFirst(const OccupancyGrid& grid, uint32_t start, Direction reverse) -> std::optional<uint32_t> {
+        m_frontier.clear();
+        nodeAt(start) = {m_stamp, start, 0u};
+        m_frontier.push_back(start);
+
+        for (size_t i = 0u; i < m_frontier.size(); i++) {
+            const uint32_t cell = m_frontier[i];
+
+            if (cell != start && grid.hasFlag(cell, OccupancyGrid::Fruit)) {
+                return cell;
+            }
+
+            if (++m_expanded > m_config.maxExpansions) {
+                return std::nullopt;
+            }
+
+            const uint32_t cost = nodeAt(cell).cost;
+
+            forEachNeighbour(grid, cell, [&](uint32_t next, Direction direction) {
+                if ((cell == start && direction == reverse) || isBlocked(grid, next)) {
+                    return;
+                }
+
+                auto& node = nodeAt(next);
+                if (node.stamp == m_stamp) {
+                    return;
+                }
+
+                node = {m_stamp, cell, cost + 1u};
+                m_frontier.push_back(next);
+            });
+        }
+
+        return std::nullopt;
+    }
+
+    /**
+     * @brief New stamp for a search, resets the chunk tables when the board changed.
+     */
+    auto beginSearch(const OccupancyGrid& grid) -> void {
+        if (grid.getWidth() != m_width || grid.getHeight() != m_height) {
+            m_width = grid.getWidth();
+            m_height = grid.getHeight();
+
+            const uint32_t last_cell = grid.cellIndex(m_width - 1u, m_height - 1u);
+            m_chunk_base.assign(last_cell / OccupancyGrid::CHUNK_CELLS + 1u, NO_CHUNK);
+            m_nodes.clear();
+            m_stamp = 0u;
+        }
+
+        if (++m_stamp == 0u) {
+            // Wrapped around, stamps of old searches could look current
+            std::ranges::fill(m_nodes, Node{0u, 0u, 0u});
+            m_stamp = 1u;
+        }
+
+        m_searches++;
+        m_expanded = 0u;
+    }
+
+    /**
+     * @brief Search state of a cell, allocates its chunk on first use. Invalidates earlier references.
+     */
+    auto nodeAt(uint32_t cell) -> Node& {
+        auto& base = m_chunk_base[cell / OccupancyGrid::CHUNK_CELLS];
+
+        if (base == NO_CHUNK) {
+            base = static_cast<uint32_t>(m_nodes.size());
+            m_nodes.resize(m_nodes.size() + OccupancyGrid::CHUNK_CELLS, Node{0u, 0u, 0u});
+        }
+
+        return m_nodes[base + cell % OccupancyGrid::CHUNK_CELLS];
+    }
+
+    auto followsPath(const Board& board, uint32_t head) const -> bool {
+        const auto& grid = board.getGrid();
+
+        return m_step < m_path.size() &&
+            (m_step == 0u ? m_start : m_path[m_step - 1u]) == head &&
+            !isBlocked(grid, m_path[m_step]) &&
+            grid.hasFlag(m_path.back(), OccupancyGrid::Fruit);
+    }
+
+    /**
+     * @brief Straight on if that's free, else a turn into a free cell.
+     */
+    auto safeDirection(const Board& board, uint32_t head) const -> std::optional<Direction> {
+        const auto& grid = board.getGrid();
+        const auto heading = static_cast<int32_t>(board.getSnake().getHeading());
+
+        for (const int32_t turn : {0, 3, 1}) {
+            const auto direction = static_cast<Direction>((heading + turn) % 4);
+            const auto next = neighbour(grid, head, direction);
+
+            if (next && !isBlocked(grid, *next)) {
+                return direction;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Turn towards the direction if the snake can take it now.
+     *
+     * Free-mode snakes turn wherever they are, so the turn is only sent on the tick closest
+     * to the cell's center, or the one after when the snake couldn't turn yet, and the snake
+     * stays close to the grid's lanes. Grid-mode turns take effect on the next cell step anyway.
+     */
+    static auto steer(const Board& board, uint32_t head, Direction direction) -> InputAction {
+        const auto& snake = board.getSnake();
+        const auto heading = snake.getHeading();
+
+        if (direction == heading || board.getBufferedTurns() > 0u) {
+            return InputAction::None;
+        }
+
+        if (snake.getMovement() == Snake::Movement::Free) {
+            const auto center = board.getGrid().cellCenter(head);
+            const auto position = snake.getHeadPosition();
+            const auto offset = DIRECTION_OFFSETS[static_cast<size_t>(heading)];
+
+            const float along = (position.x - center.x) * offset.x + (position.y - center.y) * offset.y;
+            const float step = snake.getSpeed() / static_cast<float>(board.getTickRate());
+
+            if (!snake.canTurn() || along < -step / 2.f || along >= std::min(1.5f * step, TILE_SIZE / 2.f)) {
+                return InputAction::None;
+            }
+        }
+
+        const auto left = static_cast<Direction>((static_cast<int32_t>(heading) + 3) % 4);
+
+        return direction == left ? InputAction::TurnLeft : InputAction::TurnRight;
+    }
+
+    static auto headCell(const Board& board) -> std::optional<uint32_t> {
+        const auto& snake = board.getSnake();
+        const auto& grid = board.getGrid();
+
+        if (snake.getMovement() == Snake::Movement::Grid) {
+            const auto cell = snake.getCells().fromHead(0u).position;
+            if (!grid.contains(cell.x, cell.y)) {
+                return std::nullopt;
+            }
+
+            return grid.cellIndex(static_cast<uint32_t>(cell.x), static_cast<uint32_t>(cell.y));
+        }
+
+        return grid.cellAt(snake.getHeadPosition());
+    }
+
+    static auto isBlocked(const OccupancyGrid& grid, uint32_t cell) -> bool {
+        return grid.hasFlag(cell, OccupancyGrid::Rock) || grid.hasSegment(cell);
+    }
+
+    static auto neighbour(const OccupancyGrid& grid, uint32_t cell, Direction direction) -> std::optional<uint32_t> {
+        const auto coords = grid.cellCoords(cell);
+        const auto offset = DIRECTION_OFFSETS[static_cast<size_t>(direction)];
+        const int32_t x = static_cast<int32_t>(coords.x) + offset.x;
+        const int32_t y = static_cast<int32_t>(coords.y) + offset.y;
+
+        if (!grid.contains(x, y)) {
+            return std::nullopt;
+        }
+
+        return grid.cellIndex(static_cast<uint32_t>(x), static_cast<uint32_t>(y));
+    }
+
+    template<typename Fn>
+    static auto forEachNeighbour(const OccupancyGrid& grid, uint32_t cell, Fn&& fn) -> void {
+        for (int32_t direction = 0; direction < 4; direction++) {
+            if (const auto next = neighbour(grid, cell, static_cast<Direction>(direction))) {
+                fn(*next, static_cast<Direction>(direction));
+            }
+        }
+    }
+
+    static auto directionTo(const OccupancyGrid& grid, uint32_t from, uint32_t to) -> Direction {
+        const auto a = grid.cellCoords(from);
+        const auto b = grid.cellCoords(to);
+
+        if (b.x != a.x) {
+            return b.x > a.x ? Direction::Right : Direction::Left;
+        }
+
+        return b.y > a.y ? Direction::Down : Direction::Up;
+    }
+
+    Config m_config;
+
+    // Current path, cells after m_start up to the fruit, m_path[m_step] is entered next
+    std::vector<uint32_t> m_path;
+    size_t m_step{0u};
+    uint32_t m_start{NO_CELL};
+    uint32_t m_failed_cell{NO_CELL}; // head cell the last search failed from, not retried there
+
+    // Search buffers, kept between searches
+    uint32_t m_width{0u};
+    uint32_t m_height{0u};
+    std::vector<uint32_t> m_chunk_base; // per grid chunk, offset into m_nodes or NO_CHUNK
+    std::vector<Node> m_nodes;
+    std::vector<OpenEntry> m_open;       // A* binary heap
+    std::vector<uint32_t> m_frontier;    // breadth-first queue
+    uint32_t m_stamp{0u};
+
+    uint64_t m_searches{0u};
+    uint32_t m_expanded{0u};
+}; // class Autopilot
+
+} // namespace snek
@@ -0,0 +1,76 @@
+/**
+ * @file BatchRunner.hpp
+ *
+ * @brief Plays many independent Boards to the end in parallel, e.g. for bot evaluation.
+ *
+ * Boards share no mutable state (each owns its RNG), so every game runs on whichever
+ * worker of the WorkStealingPool picks it up, without any synchronization.
+ *
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "snek/Board.hpp"
+#include "snek/Controller.hpp"
+#include "snek/WorkStealingPool.hpp"
+
+namespace snek {
+
+struct GameResult {
+    uint32_t seed;
+    uint64_t ticks;  // ticks survived
+    uint32_t length; // snake length at the end
+    Board::State state;
+    Board::DeathCause cause;
+};
+
+struct BatchConfig {
+    Board::Config board;
+    uint32_t games{1000u};
+    uint32_t baseSeed{0u};           // game i is seeded with baseSeed + i
+    uint64_t maxTicks{100'000u};     // games still running after this many ticks are cut off
+};
+
+/**
+ * @brief Runs config.games games on the pool and returns their results in game order.
+ *
+ * make_controller(uint32_t seed) -> std::unique_ptr<IController> creates the controller
+ * of a game, it's called concurrently from all workers. Every game gets its own controller,
+ * which then only ever runs on the game's worker.
+ */
+template<typename MakeController>
+auto runBatch(WorkStealingPool& pool, const BatchConfig& config, const MakeController& make_controller) -> std::vector<GameResult> {
+    std::vector<GameResult> results(config.games);
+
+    pool.parallelFor(config.games, [&](uint64_t game, uint32_t) {
+        const auto seed = config.baseSeed + static_cast<uint32_t>(game);
+
+        auto board_config = config.board;
+        board_config.seed = seed;
+
+        Board board{board_config};
+        const std::unique_ptr<IController> controller = make_controller(seed);
+
+        uint64_t tick = 0u;
+        while (tick < config.maxTicks && board.getState() == Board::State::Playing) {
+            board.update(controller->decide(board));
+            tick++;
+        }
+
+        results[game] = GameResult{
+            seed,
+            tick,
+            static_cast<uint32_t>(board.getSnake().getLength()),
+            board.getState(),
+            board.getDeathCause()
+        };
+    });
+
+    return results;
+}
+
+} // namespace snek
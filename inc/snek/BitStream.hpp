@@ -0,0 +1,149 @@
+/**
+ * @file BitStream.hpp
+ *
+ * @brief Bit-level writer and reader for the network packets, values take as few bits as they need.
+ *
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace snek {
+
+/**
+ * @brief Packs values least significant bit first, the last byte is padded with zeros.
+ */
+class BitWriter {
+public:
+    /**
+     * @brief Writes the low count bits of value, count up to 64.
+     */
+    auto putBits(uint64_t value, uint32_t count) -> void {
+        for (uint32_t written = 0u; written < count;) {
+            const auto offset = static_cast<uint32_t>(m_bits % 8u);
+            if (offset == 0u) {
+                m_bytes.push_back(0u);
+            }
+
+            const uint32_t chunk = std::min(8u - offset, count - written);
+            const auto bits = (value >> written) & ((1u << chunk) - 1u);
+
+            m_bytes.back() |= static_cast<uint8_t>(bits << offset);
+            written += chunk;
+            m_bits += chunk;
+        }
+    }
+
+    auto putBool(bool value) -> void {
+        putBits(value ? 1u : 0u, 1u);
+    }
+
+    /**
+     * @brief Elias gamma code of value + 1: 0 takes 1 bit, 1 to 2 take 3, 3 to 6 take 5, ...
+     */
+    auto putUnsigned(uint64_t value) -> void {
+        const uint64_t code = value + 1u;
+        const auto width = static_cast<uint32_t>(std::bit_width(code));
+
+        putBits(0u, width - 1u);
+        putBits(1u, 1u);
+        putBits(code, width - 1u); // the leading 1 is implied
+    }
+
+    /**
+     * @brief Zigzag mapped (0, -1, 1, -2, ...) then gamma coded, small magnitudes are cheap.
+     */
+    auto putSigned(int64_t value) -> void {
+        putUnsigned((static_cast<uint64_t>(value) << 1u) ^ static_cast<uint64_t>(value >> 63u));
+    }
+
+    auto getBytes() const -> std::span<const uint8_t> {
+        return m_bytes;
+    }
+
+    auto getBitCount() const -> size_t {
+        return m_bits;
+    }
+
+    auto clear() -> void {
+        m_bytes.clear();
+        m_bits = 0u;
+    }
+private:
+    std::vector<uint8_t> m_bytes;
+    size_t m_bits{0u};
+}; // class BitWriter
+
+/**
+ * @brief Reads what BitWriter wrote. Reading past the end yields zeros and marks the reader failed.
+ */
+class BitReader {
+public:
+    explicit BitReader(std::span<const uint8_t> bytes)
+        : m_bytes(bytes)
+    {}
+
+    auto getBits(uint32_t count) -> uint64_t {
+        if (count > remainingBits()) {
+            m_failed = true;
+            m_pos = m_bytes.size() * 8u;
+
+            return 0u;
+        }
+
+        uint64_t value = 0u;
+        for (uint32_t read = 0u; read < count;) {
+            const auto offset = static_cast<uint32_t>(m_pos % 8u);
+            const uint32_t chunk = std::min(8u - offset, count - read);
+            const auto bits = (m_bytes[m_pos / 8u] >> offset) & ((1u << chunk) - 1u);
+
+            value |= static_cast<uint64_t>(bits) << read;
+            read += chunk;
+            m_pos += chunk;
+        }
+
+        return value;
+    }
+
+    auto getBool() -> bool {
+        return getBits(1u) != 0u;
+    }
+
+    auto getUnsigned() -> uint64_t {
+        uint32_t zeros = 0u;
+        while (!getBool()) {
+            if (m_failed || ++zeros > 63u) {
+                m_failed = true;
+
+                return 0u;
+            }
+        }
+
+        return ((uint64_t{1u} << zeros) | getBits(zeros)) - 1u;
+    }
+
+    auto getSigned() -> int64_t {
+        const auto value = getUnsigned();
+
+        return static_cast<int64_t>(value >> 1u) ^ -static_cast<int64_t>(value & 1u);
+    }
+
+    auto remainingBits() const -> size_t {
+        return m_bytes.size() * 8u - m_pos;
+    }
+
+    auto failed() const -> bool {
+        return m_failed;
+    }
+private:
+    std::span<const uint8_t> m_bytes;
+    size_t m_pos{0u};
+    bool m_failed{false};
+}; // class BitReader
+
+} // namespace snek
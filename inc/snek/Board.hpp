@@ -7,270 +7,1531 @@
 
 #include <vector>
 #include <random>
+#include <optional>
+#include <ranges>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <print>
+#include <span>
 
-#include "snek/ILayer.hpp"
-#include "snek/utils.hpp"
+#include "snek/Camera.hpp"
+#include "snek/collision.hpp"
+#include "snek/EntityChunks.hpp"
 #include "snek/Snake.hpp"
-#include "snek/Input.hpp"
-#include "snek/SoundSystem.hpp"
+#include "snek/OccupancyGrid.hpp"
+#include "snek/Profiler.hpp"
+#include "snek/InputAction.hpp"
+#include "snek/SpatialHash.hpp"
+#include "snek/StateStream.hpp"
+#include "snek/WorkStealingPool.hpp"
 
 namespace snek {
 
-class Board : public ILayer {
+/**
+ * @brief Things happening on the board that frontends (audio, rendering, bots) may react to.
+ */
+enum class BoardEvent {
+    Turned,
+    FruitEaten,
+    SnakeDied
+};
+
+/**
+ * @brief Optional observer attached to a Board, the simulation itself never depends on one.
+ */
+struct IBoardListener {
+    virtual ~IBoardListener() = default;
+
+    virtual auto onBoardEvent(BoardEvent event) -> void = 0;
+};
+
+/**
+ * @brief Pure simulation state: snake, fruits, rocks, collisions and game state.
+ *
+ * Doesn't touch any window, GL context or audio device, so it can be ticked headless.
+ * The camera is plain math too, it only decides which part of the board a frontend shows.
+ *
+ * Besides the player's snake the board may hold any number of arena snakes, steered by
+ * whoever calls update(). They eat the same fruit and collide with each other and with
+ * the player, they respawn when they die, only the player's death ends the game.
+ */
+class Board {
 public:
-    Board() {
+    struct Config {
+        uint32_t width{40u};  // in tiles, 1 to BOARD_MAX_SIZE
+        uint32_t height{30u}; // in tiles, 1 to BOARD_MAX_SIZE
+        uint32_t rocks{10u};
+        uint32_t tickRate{SIMULATION_TICK_RATE};
+        uint32_t turnBuffer{INPUT_TURN_BUFFER_DEPTH}; // turns held until the snake can take them, up to INPUT_TURN_BUFFER_MAX
+        uint32_t arenaSnakes{0u}; // snakes besides the player's, each respawns on a random free cell when it dies
+        Snake::Movement movement{Snake::Movement::Free};
+        std::optional<uint32_t> seed; // drawn from std::random_device when empty
+    };
+
+    Board()
+        : Board(Config{})
+    {}
+
+    explicit Board(const Config& config)
+        : m_tick_duration(1.f / static_cast<float>(std::max(config.tickRate, 1u)))
+        , m_tick_rate(std::max(config.tickRate, 1u))
+        , m_width(std::clamp(config.width, 1u, BOARD_MAX_SIZE))
+        , m_height(std::clamp(config.height, 1u, BOARD_MAX_SIZE))
+        , m_requested_rocks(config.rocks)
+        , m_turn_buffer_depth(std::min(config.turnBuffer, INPUT_TURN_BUFFER_MAX))
+        , m_level_id(nextLevelId())
+        , m_seed(config.seed.value_or(std::random_device{}()))
+        , m_rng(m_seed)
+        , m_snake(SNAKE_INITIAL_LENGTH, middleCellCenter(m_width, m_height), config.movement)
+        , m_camera(
+            {std::min(m_width, CAMERA_VIEW_TILES_X) * TILE_SIZE, std::min(m_height, CAMERA_VIEW_TILES_Y) * TILE_SIZE},
+            {m_width * TILE_SIZE, m_height * TILE_SIZE})
+    {
+        if (m_snake.getMovement() == Snake::Movement::Grid) {
+            linkGridSnake();
+        } else {
+            syncSnakeCells();
+        }
+
+        m_camera.snapTo(m_snake.getHeadPosition());
+
         // Initial fruit spawn
         spawnFruit();
 
         // Create some rocks
-        createRocks(10u);
+        createRocks(m_requested_rocks);
+
+        if (config.arenaSnakes > 0u) {
+            spawnArena(config.arenaSnakes);
+        }
+
+        cacheRockState();
     }
 
     enum class State {
         Playing,
         Paused,
-        GameOver
+        GameOver,
+        Won
     };
 
-    auto update(InputAction action) -> void override {
+    /**
+     * @brief What ended the game, None while it's still going or when it was won.
+     */
+    enum class DeathCause {
+        None,
+        Wall,
+        Rock,
+        Self,
+        Rival // another snake's body, or its head when that snake was at least as long
+    };
+
+    /**
+     * @brief Advances the simulation by exactly one fixed tick of 1 / tickRate seconds.
+     *
+     * Turns the snake can't take yet (it travels a tile between turns) wait in the turn
+     * buffer and are taken on later ticks in order, so a quick double turn isn't lost.
+     * One turn is taken per tick at most, turns past the buffer depth are dropped.
+     *
+     * @param arena_actions Action of every arena snake by index, missing ones go straight.
+     *                      Arena snakes turn right away when they can, nothing is buffered.
+     */
+    auto update(InputAction action, std::span<const InputAction> arena_actions = {}) -> void {
+        SNEK_PROFILE_SCOPE("Board::update");
+
         if (m_state != State::Playing) {
             return;
         }
 
-        switch (action) {
-            case InputAction::TurnLeft:
-                SoundSystem::Play(RESPATH_TURN_WAV);
-                m_snake.turnLeft();
-                break;
-            case InputAction::TurnRight:
-                SoundSystem::Play(RESPATH_TURN_WAV);
-                m_snake.turnRight();
-                break;
-            default:
-                break;
+        if (action == InputAction::TurnLeft || action == InputAction::TurnRight) {
+            // With a depth of 0 the turn is still tried this tick, it just can't wait
+            if (m_turn_count < std::max(m_turn_buffer_depth, 1u)) {
+                m_turns[m_turn_count++] = action;
+            } else {
+                m_turns_dropped++;
+            }
         }
 
-        m_snake.move();
+        takeBufferedTurn();
 
-        handle_collision();
+        m_snake.move(m_tick_duration);
+
+        // The arena snakes move in the same step and every body is rehashed before the
+        // player's head is resolved, so no fruit respawns on a cell a snake just entered
+        if (!m_arena.empty()) {
+            moveArena(arena_actions);
+        }
+
+        if (m_snake.getMovement() == Snake::Movement::Grid) {
+            advanceGridSnake();
+        } else {
+            syncSnakeCells();
+            handle_collision();
+        }
+
+        if (!m_arena.empty() && m_state == State::Playing) {
+            resolveArena();
+        }
+
+        m_camera.follow(m_snake.getHeadPosition());
     }
 
-    auto render(Renderer& renderer) const -> void override {
-        const sf::Vector2f BOARD_SIZE = {
-            m_width * snek::TILE_SIZE,
-            m_height * snek::TILE_SIZE
-        };
+    auto getTickRate() const -> uint32_t {
+        return m_tick_rate;
+    }
 
-        sf::View view(BOARD_SIZE / 2.f, BOARD_SIZE);
+    auto getWidth() const -> uint32_t {
+        return m_width;
+    }
 
-        renderer.setView(view);
+    auto getHeight() const -> uint32_t {
+        return m_height;
+    }
 
-        for (const auto* entity : getEntities()) {
-            renderer.draw(entity);
-        }
+    /**
+     * @brief Identifies the level layout (rocks), unique per constructed board and kept by copies.
+     *
+     * Rocks never change after construction, so anything derived from them only needs
+     * rebuilding when this changes.
+     */
+    auto getLevelId() const -> uint64_t {
+        return m_level_id;
+    }
+
+    /**
+     * @brief Config::rocks the board was made with, crowded boards may hold fewer.
+     */
+    auto getRequestedRocks() const -> uint32_t {
+        return m_requested_rocks;
+    }
+
+    /**
+     * @brief Seed of the board's RNG, the same seed and inputs replay the same game.
+     */
+    auto getSeed() const -> uint32_t {
+        return m_seed;
     }
 
     auto getState() const -> State {
         return m_state;
     }
 
-    auto getEntities() const -> std::vector<const Entity*> {
-        std::vector<const Entity*> entities;
+    auto getDeathCause() const -> DeathCause {
+        return m_death_cause;
+    }
+
+    auto getTurnBufferDepth() const -> uint32_t {
+        return m_turn_buffer_depth;
+    }
+
+    /**
+     * @brief Turns fed to update() that are waiting for the snake to be able to turn.
+     */
+    auto getBufferedTurns() const -> uint32_t {
+        return m_turn_count;
+    }
+
+    /**
+     * @brief Turns taken so far, each one notified as BoardEvent::Turned.
+     */
+    auto getTurnsTaken() const -> uint64_t {
+        return m_turns_taken;
+    }
+
+    /**
+     * @brief Turns fed to update() that were never taken, the buffer being full.
+     */
+    auto getTurnsDropped() const -> uint64_t {
+        return m_turns_dropped;
+    }
+
+    /**
+     * @brief Snakes besides the player's, in the order update() takes their actions.
+     */
+    auto getArenaSnakes() const -> std::span<const Snake> {
+        return m_arena;
+    }
+
+    /**
+     * @brief Arena snakes that died (and respawned) so far.
+     */
+    auto getArenaDeaths() const -> uint64_t {
+        return m_arena_deaths;
+    }
+
+    /**
+     * @brief Lets update() move and check the arena snakes on the pool, not owned.
+     *
+     * nullptr (the default) runs them on the calling thread. The outcome is the same
+     * either way, whatever the number of threads. Never the pool update() itself runs
+     * on, parallelFor() isn't reentrant.
+     */
+    auto setPool(WorkStealingPool* pool) -> void {
+        m_pool = pool;
+    }
+
+    /**
+     * @brief Calls fn(entity) for every snake segment, fruit and rock, allocates nothing.
+     */
+    template<typename Fn>
+    auto forEachEntity(Fn&& fn) const -> void {
+        for (const auto& segment : m_snake.getEntities()) {
+            fn(segment);
+        }
+
+        for (const auto& snake : m_arena) {
+            for (const auto& segment : snake.getEntities()) {
+                fn(segment);
+            }
+        }
+
+        m_fruits.forEach(fn);
+        m_rocks.forEach(fn);
+    }
+
+    /**
+     * @brief Like forEachEntity(), but only visits what may overlap the area.
+     *
+     * Fruits and rocks are culled per chunk, the cost follows the area rather than the board
+     * size. Snake segments are tested one by one, snakes are the only things that move.
+     *
+     * @return Number of static entity chunks visited.
+     */
+    template<typename Fn>
+    auto forEachEntityIn(const sf::FloatRect& area, Fn&& fn) const -> uint32_t {
+        return forEachDynamicEntityIn(area, fn) + m_rocks.forEachIn(area, fn);
+    }
+
+    /**
+     * @brief Like forEachEntityIn(), without the rocks, which never change within a level.
+     */
+    template<typename Fn>
+    auto forEachDynamicEntityIn(const sf::FloatRect& area, Fn&& fn) const -> uint32_t {
+        const sf::FloatRect grown{area.position - sf::Vector2f{TILE_SIZE, TILE_SIZE}, area.size + sf::Vector2f{2.f * TILE_SIZE, 2.f * TILE_SIZE}};
+
+        const auto visit = [&](const Snake& snake) {
+            for (const auto& segment : snake.getEntities()) {
+                if (grown.contains(segment.position)) {
+                    fn(segment);
+                }
+            }
+        };
+
+        visit(m_snake);
+        std::ranges::for_each(m_arena, visit);
+
+        return m_fruits.forEachIn(area, fn);
+    }
+
+    auto getEntityCount() const -> size_t {
+        size_t segments = m_snake.getLength();
+        for (const auto& snake : m_arena) {
+            segments += snake.getLength();
+        }
+
+        return segments + m_fruits.size() + m_rocks.size();
+    }
+
+    auto getSnake() const -> const Snake& {
+        return m_snake;
+    }
+
+    auto getFruits() const -> const EntityChunks& {
+        return m_fruits;
+    }
 
-        const auto snake_entities = m_snake.getEntities();
+    auto getRocks() const -> const EntityChunks& {
+        return m_rocks;
+    }
+
+    /**
+     * @brief Spatial index of the board, read-only, e.g. for bots planning a path.
+     */
+    auto getGrid() const -> const OccupancyGrid& {
+        return m_grid;
+    }
+
+    auto getCamera() const -> const Camera& {
+        return m_camera;
+    }
+
+    auto addListener(IBoardListener* listener) -> void {
+        m_listeners.push_back(listener);
+    }
+
+    auto removeListener(IBoardListener* listener) -> void {
+        std::erase(m_listeners, listener);
+    }
+
+    /**
+     * @brief Replaces out with a flat copy of the whole simulation state, see restoreState().
+     *
+     * Everything is memcpy'd in the build's native layout, the rocks come pre-serialized,
+     * so a save is a handful of bulk copies and allocates nothing once out is big enough.
+     * Listeners, the pool, the level id and the layout of the body hash aren't state, they
+     * stay with the board.
+     */
+    auto saveState(std::vector<uint8_t>& out) const -> void {
+        SNEK_PROFILE_SCOPE("Board::saveState");
+
+        out.clear();
+        StateWriter writer{out};
+
+        StateHeader header{
+            .magic = STATE_MAGIC,
+            .version = STATE_VERSION,
+            .width = m_width,
+            .height = m_height,
+            .rocks = m_requested_rocks,
+            .tickRate = m_tick_rate,
+            .turnBuffer = m_turn_buffer_depth,
+            .arenaSnakes = static_cast<uint32_t>(m_arena.size()),
+            .seed = m_seed,
+            .movement = m_snake.getMovement()};
+        writer.put(header);
+
+        writer.put(m_state);
+        writer.put(m_death_cause);
+        writer.put(m_turns);
+        writer.put(m_turn_count);
+        writer.put(m_turns_taken);
+        writer.put(m_turns_dropped);
+        writer.put(m_rng);
+        writer.put(m_camera);
+
+        m_snake.saveState(writer);
 
-        entities.reserve(snake_entities.size() + m_fruits.size());
+        writer.put(static_cast<uint32_t>(m_rock_state.size()));
+        writer.putBytes(m_rock_state);
+        m_fruits.saveState(writer);
 
-        entities.insert(
-            entities.end(),
-            snake_entities.begin(),
-            snake_entities.end());
+        writer.put(m_arena_deaths);
+        for (const auto& snake : m_arena) {
+            snake.saveState(writer);
+        }
+
+        header.byteCount = static_cast<uint32_t>(writer.size());
+        writer.patch(0u, header);
+    }
+
+    /**
+     * @brief Puts the board back in the state saveState() captured, of this board or another one.
+     *
+     * The state must come from a board of the same size, movement, tick rate, turn buffer
+     * and arena snake count (readStateConfig() tells which), this board is left untouched
+     * otherwise. When the rocks are the ones already here, which is always the case when
+     * rolling back, only the fruits and snakes are relinked into the grid. Otherwise the
+     * level is rebuilt and gets a new level id.
+     *
+     * The whole state is read and checked before any of it is applied, so a state that
+     * doesn't fit or is corrupted leaves this board as it was.
+     *
+     * @return false (reported on stderr) when the state doesn't fit this board or is corrupted.
+     */
+    auto restoreState(std::span<const uint8_t> state) -> bool {
+        SNEK_PROFILE_SCOPE("Board::restoreState");
+
+        StateReader reader{state};
+
+        const auto header = readStateHeader(reader, state.size());
+        if (!header) {
+            return false;
+        }
+
+        const bool fits = header->width == m_width && header->height == m_height &&
+            header->tickRate == m_tick_rate && header->turnBuffer == m_turn_buffer_depth &&
+            header->arenaSnakes == m_arena.size() && header->movement == m_snake.getMovement();
+        if (!fits) {
+            std::println(stderr, "Board state of a {}x{} board with {} arena snakes doesn't fit this board",
+                header->width, header->height, header->arenaSnakes);
 
-        for (const auto& fruit : m_fruits) {
-            entities.push_back(&fruit);
+            return false;
         }
 
-        for (const auto& rock : m_rocks) {
-            entities.push_back(&rock);
+        if (!restoreBody(reader)) {
+            std::println(stderr, "Corrupted board state");
+
+            return false;
         }
 
-        return entities;
+        m_seed = header->seed;
+        m_requested_rocks = header->rocks;
+
+        return true;
+    }
+
+    /**
+     * @brief Config of the board a state was saved from, make one from it to restore the state into.
+     *
+     * The seed is the one the board was made with, the state holds its RNG as it was when saved.
+     */
+    static auto readStateConfig(std::span<const uint8_t> state) -> std::optional<Config> {
+        StateReader reader{state};
+
+        const auto header = readStateHeader(reader, state.size());
+        if (!header) {
+            return std::nullopt;
+        }
+
+        return Config{
+            .width = header->width,
+            .height = header->height,
+            .rocks = header->rocks,
+            .tickRate = header->tickRate,
+            .turnBuffer = header->turnBuffer,
+            .arenaSnakes = header->arenaSnakes,
+            .movement = header->movement,
+            .seed = header->seed};
     }
 private:
+    struct StateHeader {
+        std::array<char, 4> magic;
+        uint32_t version;
+        uint32_t byteCount{0u}; // of the whole state, header included
+        uint32_t width;
+        uint32_t height;
+        uint32_t rocks;
+        uint32_t tickRate;
+        uint32_t turnBuffer;
+        uint32_t arenaSnakes;
+        uint32_t seed;
+        Snake::Movement movement;
+    };
+
+    static constexpr std::array<char, 4> STATE_MAGIC = {'S', 'N', 'K', 'S'};
+    static constexpr uint32_t STATE_VERSION = 2u;
+
     // Board properties
     State m_state{State::Playing};
+    DeathCause m_death_cause{DeathCause::None};
 
-    uint32_t m_width{40u};
-    uint32_t m_height{30u};
+    float m_tick_duration;
+    uint32_t m_tick_rate;
+
+    uint32_t m_width;
+    uint32_t m_height;
+    uint32_t m_requested_rocks;
+    uint32_t m_turn_buffer_depth;
+    uint64_t m_level_id;
+
+    // Turns fed to update() the snake couldn't take yet, oldest first
+    std::array<InputAction, INPUT_TURN_BUFFER_MAX> m_turns{};
+    uint32_t m_turn_count{0u};
+    uint64_t m_turns_taken{0u};
+    uint64_t m_turns_dropped{0u};
+
+    // Every random decision of the simulation draws from this one generator
+    uint32_t m_seed;
+    std::mt19937 m_rng;
 
     // Entities
     Snake m_snake;
-    std::vector<Entity> m_fruits;
-    std::vector<Entity> m_rocks;
+    EntityChunks m_fruits{m_width, m_height};
+    EntityChunks m_rocks{m_width, m_height};
+    std::vector<uint8_t> m_rock_state; // m_rocks as saveState() writes them, they never change
 
-    auto spawnFruit() -> void {
-        static std::mt19937 rng(std::random_device{}());
-        std::uniform_int_distribution<uint32_t> dist(0u, m_width * m_height - 1u);
+    Camera m_camera;
 
-        uint32_t idx;
-        Entity fruit;
+    // Spatial index of all of the above
+    OccupancyGrid m_grid{m_width, m_height};
 
-        const auto collidesWithEntity = [&]() -> bool {
-            for (const auto* entity : getEntities()) {
-                if (checkCollision({fruit.position, fruit.size}, {entity->position, entity->size})) {
-                    return true;
-                }
+    // Restores read into these and swap them in once the whole state checks out, see restoreBody().
+    // Kept between restores so rolling back reuses their storage.
+    std::optional<Snake> m_restored_snake;
+    std::optional<EntityChunks> m_restored_fruits;
+    std::vector<Snake> m_restored_arena;
+
+    // Arena snakes, hashed by cell along with the player's snake for the collisions between snakes.
+    // Their bodies stay out of m_grid, whose segment lists belong to the player's snake.
+    std::vector<Snake> m_arena;
+    std::vector<DeathCause> m_arena_verdicts; // of the tick being resolved, one slot per snake
+    uint64_t m_arena_deaths{0u};
+    SpatialHash m_body_hash;
+    WorkStealingPool* m_pool{nullptr};
+
+    // Hash entries of a snake's body as last synced, kept per snake in snakeAt() order
+    struct BodyEntries {
+        std::vector<uint32_t> ids; // by ring slot in grid mode, by segment in free mode, NONE when off the board
+        uint32_t tailSeq{0u};      // grid mode: the ring as last synced
+        uint32_t headSeq{0u};
+        uint32_t capacity{0u};
+        uint32_t enteredFrom{0u};  // grid mode: head seq before the last move, later cells were entered by it
+    };
+    std::vector<BodyEntries> m_bodies;
+
+    // Grid-mode snake cells mirrored into m_grid so far, grid segment ids are ring slots
+    uint32_t m_synced_tail_seq{0u};
+    uint32_t m_synced_head_seq{0u};
+    uint32_t m_synced_capacity{0u};
+
+    // Observers, not owned
+    std::vector<IBoardListener*> m_listeners;
+
+    // snek_bench drives the private hot paths directly
+    friend struct BoardBenchAccess;
+
+    auto takeBufferedTurn() -> void {
+        if (m_turn_count == 0u) {
+            return;
+        }
+
+        if (m_snake.canTurn()) {
+            if (m_turns.front() == InputAction::TurnLeft) {
+                m_snake.turnLeft();
+            } else {
+                m_snake.turnRight();
             }
 
-            return false;
-        };
+            m_turns_taken++;
+            notify(BoardEvent::Turned);
+        } else if (m_turn_buffer_depth > 0u) {
+            return;
+        } else {
+            m_turns_dropped++;
+        }
 
-        do {
-            idx = dist(rng);
+        std::shift_left(m_turns.begin(), m_turns.begin() + m_turn_count, 1);
+        m_turn_count--;
+    }
 
-            fruit.position = {
-                (idx % m_width) * snek::TILE_SIZE + snek::TILE_SIZE / 2.f,
-                (idx / m_width) * snek::TILE_SIZE + snek::TILE_SIZE / 2.f
-            };
-            fruit.size = {snek::TILE_SIZE, snek::TILE_SIZE};
-        } while (collidesWithEntity());
+    static auto nextLevelId() -> uint64_t {
+        static std::atomic<uint64_t> next{1u};
 
+        return next.fetch_add(1u, std::memory_order_relaxed);
+    }
 
-        fruit.direction = Direction::Up; // fruits don't have direction, but set to Up by default
-        fruit.texture = TextureManager::getTexture("res/assets/snake_sprites.png");
-        fruit.textureIndex = 2u;
-        fruit.rotationOffsetDegrees = 90.f;
+    static auto middleCellCenter(uint32_t width, uint32_t height) -> sf::Vector2f {
+        return {(width / 2u + 0.5f) * TILE_SIZE, (height / 2u + 0.5f) * TILE_SIZE};
+    }
 
-        m_fruits.push_back(std::move(fruit));
+    auto notify(BoardEvent event) -> void {
+        for (auto* listener : m_listeners) {
+            listener->onBoardEvent(event);
+        }
     }
 
-    auto createRocks(const uint32_t count) -> void {
-        static std::mt19937 rng(std::random_device{}());
+    auto die(DeathCause cause) -> void {
+        m_death_cause = cause;
+        m_state = State::GameOver;
 
-        std::vector<bool> occupied(m_width * m_height, false);
+        notify(BoardEvent::SnakeDied);
+    }
 
-        for (const auto* entity : getEntities()) {
-            const uint32_t x = static_cast<uint32_t>(entity->position.x) / static_cast<uint32_t>(snek::TILE_SIZE);
-            const uint32_t y = static_cast<uint32_t>(entity->position.y) / static_cast<uint32_t>(snek::TILE_SIZE);
+    /**
+     * @brief Places a fruit on a uniformly random free cell in constant time.
+     *
+     * @return false when the board is full, there's nowhere left to put a fruit.
+     */
+    auto spawnFruit() -> bool {
+        // A free cell has no segment centered in it, but a segment in a neighbouring
+        // cell can still overlap it partially. Retry a few times to avoid those,
+        // then settle for the last candidate so spawning stays O(1).
+        constexpr uint32_t MAX_OVERLAP_RETRIES = 8u;
 
-            occupied[y * m_width + x] = true;
+        const uint32_t free_count = m_grid.getFreeCellCount();
+        if (free_count == 0u) {
+            return false;
         }
 
-        // Check for 9-cell availability
-        const auto isAvailable = [&](uint32_t x, uint32_t y) -> bool {
-            for (int32_t dy = -1; dy <= 1; dy++) {
-                for (int32_t dx = -1; dx <= 1; dx++) {
-                    const int32_t nx = static_cast<int32_t>(x) + dx;
-                    const int32_t ny = static_cast<int32_t>(y) + dy;
+        std::uniform_int_distribution<uint32_t> dist(0u, free_count - 1u);
 
-                    if (nx >= 0 && nx < static_cast<int32_t>(m_width) &&
-                        ny >= 0 && ny < static_cast<int32_t>(m_height)) {
-                        if (occupied[ny * m_width + nx]) {
-                            return false;
-                        }
-                    }
-                }
-            }
+        uint32_t idx = m_grid.getFreeCell(dist(m_rng));
+        for (uint32_t retry = 0u; retry < MAX_OVERLAP_RETRIES && isCellBlocked(idx); retry++) {
+            idx = m_grid.getFreeCell(dist(m_rng));
+        }
 
-            return true;
+        Entity fruit;
+        fruit.position = m_grid.cellCenter(idx);
+        fruit.previousPosition = fruit.position;
+        fruit.size = {snek::TILE_SIZE, snek::TILE_SIZE};
+        fruit.direction = Direction::Up; // fruits don't have direction, but set to Up by default
+        fruit.sprite = SpriteId::Fruit;
+        fruit.rotationOffsetDegrees = 90.f;
+
+        m_fruits.insert(fruit);
+        m_grid.setFlag(idx, OccupancyGrid::Fruit);
+
+        return true;
+    }
+
+    /**
+     * @brief Places up to count rocks on free cells.
+     *
+     * @return Number of rocks actually placed, lower than count on crowded boards.
+     */
+    auto createRocks(const uint32_t count) -> uint32_t {
+        // Bounded so a crowded board can't hang the level setup
+        const uint64_t max_attempts = count * 64ull;
+
+        // Rocks keep a one cell margin to everything else, including other rocks
+        const auto isAvailable = [&](uint32_t cell) -> bool {
+            bool available = true;
+
+            m_grid.forEachNeighbourhoodCell(cell, [&](uint32_t neighbour) {
+                available = available && !m_grid.isOccupied(neighbour);
+            });
+
+            return available;
         };
 
         uint32_t placed = 0;
-        while (placed < count) {
-            std::uniform_int_distribution<uint32_t> dist(0u, m_width * m_height - 1u);
-            const uint32_t idx = dist(rng);
-            const uint32_t x = idx % m_width;
-            const uint32_t y = idx / m_width;
+        for (uint64_t attempt = 0u; placed < count && attempt < max_attempts; attempt++) {
+            const uint32_t free_count = m_grid.getFreeCellCount();
+            if (free_count == 0u) {
+                break;
+            }
+
+            std::uniform_int_distribution<uint32_t> dist(0u, free_count - 1u);
+            const uint32_t idx = m_grid.getFreeCell(dist(m_rng));
 
-            if (isAvailable(x, y)) {
+            if (isAvailable(idx)) {
                 Entity rock;
-                rock.position = {
-                    x * snek::TILE_SIZE + snek::TILE_SIZE / 2.f,
-                    y * snek::TILE_SIZE + snek::TILE_SIZE / 2.f
-                };
+                rock.position = m_grid.cellCenter(idx);
+                rock.previousPosition = rock.position;
                 rock.size = {snek::TILE_SIZE, snek::TILE_SIZE};
                 rock.direction = Direction::Up; // rocks don't have direction, but set to Up by default
-                rock.texture = TextureManager::getTexture("res/assets/snake_sprites.png");
-                rock.textureIndex = 3u;
+                rock.sprite = SpriteId::Rock;
 
                 std::uniform_real_distribution<float> rotation_dist(0.f, 360.f);
-                rock.rotationOffsetDegrees = rotation_dist(rng);
+                rock.rotationOffsetDegrees = rotation_dist(m_rng);
 
-                m_rocks.push_back(std::move(rock));
+                m_rocks.insert(rock);
+                m_grid.setFlag(idx, OccupancyGrid::Rock);
 
-                // Mark 9 cells as occupied
-                for (int32_t dy = -1; dy <= 1; dy++) {
-                    for (int32_t dx = -1; dx <= 1; dx++) {
-                        const int32_t nx = static_cast<int32_t>(x) + dx;
-                        const int32_t ny = static_cast<int32_t>(y) + dy;
+                placed++;
+            }
+        }
 
-                        if (nx >= 0 && nx < static_cast<int32_t>(m_width) &&
-                            ny >= 0 && ny < static_cast<int32_t>(m_height)) {
-                            occupied[ny * m_width + nx] = true;
-                        }
-                    }
-                }
+        return placed;
+    }
 
-                placed++;
+    /**
+     * @brief Whether a tile-sized entity centered on the cell would overlap anything.
+     *
+     * Rocks and fruits sit on cell centers so their own flag is enough, snake segments
+     * move freely and may overlap the cell from any of the neighbouring ones.
+     */
+    auto isCellBlocked(uint32_t cell) const -> bool {
+        if (m_grid.isOccupied(cell) || m_body_hash.contains(cell)) {
+            return true;
+        }
+
+        if (m_snake.getMovement() == Snake::Movement::Grid) {
+            return false; // grid-mode segments never leave their cell
+        }
+
+        const sf::FloatRect cell_rect = {m_grid.cellCenter(cell), {snek::TILE_SIZE, snek::TILE_SIZE}};
+        bool blocked = false;
+
+        m_grid.forEachNeighbourhoodCell(cell, [&](uint32_t neighbour) {
+            m_grid.forEachSegment(neighbour, [&](uint32_t segment) {
+                const auto& entity = m_snake.getEntity(segment);
+
+                blocked = blocked || checkCollision(cell_rect, {entity.position, entity.size});
+            });
+        });
+
+        return blocked;
+    }
+
+    /**
+     * @brief Relinks the snake segments whose center moved into another cell.
+     */
+    auto syncSnakeCells() -> void {
+        const auto segments = m_snake.getEntities();
+
+        for (uint32_t i = 0u; i < segments.size(); i++) {
+            m_grid.moveSegment(i, m_grid.cellAt(segments[i].position));
+        }
+    }
+
+    /**
+     * @brief Grid mode: links every current body cell into the occupancy grid.
+     */
+    auto linkGridSnake() -> void {
+        const auto& cells = m_snake.getCells();
+
+        m_grid.clearSegments();
+
+        for (uint32_t seq = cells.getTailSeq(); seq != cells.getHeadSeq() + 1u; seq++) {
+            m_grid.moveSegment(cells.slotOf(seq), gridCellOf(cells.at(seq).position));
+        }
+
+        m_synced_tail_seq = cells.getTailSeq();
+        m_synced_head_seq = cells.getHeadSeq();
+        m_synced_capacity = cells.getCapacity();
+    }
+
+    auto gridCellOf(sf::Vector2i position) const -> std::optional<uint32_t> {
+        if (!m_grid.contains(position.x, position.y)) {
+            return std::nullopt;
+        }
+
+        return m_grid.cellIndex(static_cast<uint32_t>(position.x), static_cast<uint32_t>(position.y));
+    }
+
+    /**
+     * @brief Grid mode: applies the cells the snake released and entered during the last move.
+     *
+     * Costs O(1) per cell step however long the snake is. Released tail cells go first,
+     * so the head may follow its own tail, then every entered cell is resolved in order.
+     */
+    auto advanceGridSnake() -> void {
+        SNEK_PROFILE_SCOPE("Board::advanceGridSnake");
+
+        const auto& cells = m_snake.getCells();
+
+        if (cells.getCapacity() != m_synced_capacity) {
+            // The ring reallocated and slots moved, relink the previously synced body
+            m_grid.clearSegments();
+
+            for (uint32_t seq = cells.getTailSeq(); seq != m_synced_head_seq + 1u; seq++) {
+                m_grid.moveSegment(cells.slotOf(seq), gridCellOf(cells.at(seq).position));
+            }
+
+            m_synced_capacity = cells.getCapacity();
+        } else {
+            for (uint32_t seq = m_synced_tail_seq; seq != cells.getTailSeq(); seq++) {
+                m_grid.removeSegment(cells.slotOf(seq));
+            }
+        }
+
+        m_synced_tail_seq = cells.getTailSeq();
+
+        while (m_synced_head_seq != cells.getHeadSeq()) {
+            m_synced_head_seq++;
+
+            if (const auto cause = enterGridCell(m_synced_head_seq); cause != DeathCause::None) {
+                die(cause);
+
+                return;
+            }
+
+            if (m_state != State::Playing) {
+                return;
             }
         }
     }
 
+    /**
+     * @brief Grid mode: resolves the head entering the cell of the given ring entry.
+     *
+     * @return Why the snake dies there, None when it survives.
+     */
+    auto enterGridCell(uint32_t seq) -> DeathCause {
+        const auto& cells = m_snake.getCells();
+        const auto cell = gridCellOf(cells.at(seq).position);
+
+        if (!cell) {
+            return DeathCause::Wall;
+        }
+
+        if (m_grid.hasFlag(*cell, OccupancyGrid::Rock)) {
+            return DeathCause::Rock;
+        }
+
+        if (m_grid.hasSegment(*cell)) {
+            return DeathCause::Self;
+        }
+
+        m_grid.moveSegment(cells.slotOf(seq), cell);
+
+        if (m_grid.hasFlag(*cell, OccupancyGrid::Fruit)) {
+            m_fruits.erase(m_grid.cellCenter(*cell));
+            m_grid.clearFlag(*cell, OccupancyGrid::Fruit);
+
+            m_snake.grow();
+            notify(BoardEvent::FruitEaten);
+
+            if (!spawnFruit()) {
+                m_state = State::Won;
+            }
+        }
+
+        return DeathCause::None;
+    }
+
     auto handle_collision() -> void {
-        const auto& head = *m_snake.getEntities().front();
+        SNEK_PROFILE_SCOPE("Board::handle_collision");
 
-        for (auto it = m_fruits.begin(); it != m_fruits.end(); ) {
-            const sf::Rect head_collision = {head.position, head.size};
+        const auto& head = m_snake.getHead();
+        const auto head_cell = m_grid.cellAt(head.position);
 
-            if (checkCollision(head_collision, {it->position, it->size})) {
-                m_snake.grow();
-                it = m_fruits.erase(it);
-                spawnFruit();
-                SoundSystem::Play(RESPATH_EAT_WAV);
-            } else {
-                ++it;
+        // Check collision with borders
+        if (!head_cell) {
+            die(DeathCause::Wall);
+
+            return;
+        }
+
+        if (const auto eaten_cell = fruitUnderHead(head, *head_cell)) {
+            m_fruits.erase(m_grid.cellCenter(*eaten_cell));
+            m_grid.clearFlag(*eaten_cell, OccupancyGrid::Fruit);
+
+            m_snake.grow();
+            const auto tail = static_cast<uint32_t>(m_snake.getLength() - 1u);
+            m_grid.moveSegment(tail, m_grid.cellAt(m_snake.getEntity(tail).position));
+            insertGrowth(0u);
+
+            notify(BoardEvent::FruitEaten);
+
+            if (!spawnFruit()) {
+                m_state = State::Won; // no free cell left, the snake fills the board
+
+                return;
             }
         }
         
         // collision is shrunken a bit
         constexpr float COLLISION_SHRINK_FACTOR = 0.4f;
-        const sf::Rect head_collision = {
+        const sf::Rect shrunk_collision = {
             head.position + head.size * COLLISION_SHRINK_FACTOR / 2.f,
             head.size * (1.f - COLLISION_SHRINK_FACTOR)
         };
 
-        for (const auto* entity : m_snake.getEntities() | std::views::drop(2)) {
-            if (checkCollision(head_collision, {entity->position, entity->size})) {
-                SoundSystem::Play(RESPATH_DEATH_WAV);
-                m_state = State::GameOver;
+        auto cause = DeathCause::None;
+        m_grid.forEachNeighbourhoodCell(*head_cell, [&](uint32_t cell) {
+            if (cause == DeathCause::None &&
+                m_grid.hasFlag(cell, OccupancyGrid::Rock) &&
+                checkCollision(shrunk_collision, {m_grid.cellCenter(cell), {snek::TILE_SIZE, snek::TILE_SIZE}})) {
+                cause = DeathCause::Rock;
+            }
 
-                return;
+            m_grid.forEachSegment(cell, [&](uint32_t segment) {
+                // The head and the segment right behind it always touch
+                if (segment < 2u || cause != DeathCause::None) {
+                    return;
+                }
+
+                const auto& entity = m_snake.getEntity(segment);
+                if (checkCollision(shrunk_collision, {entity.position, entity.size})) {
+                    cause = DeathCause::Self;
+                }
+            });
+        });
+
+        if (cause != DeathCause::None) {
+            die(cause);
+        }
+    }
+
+    /**
+     * @brief Free mode: the first fruit cell the head overlaps.
+     *
+     * Anything the head may overlap has its center in the 3x3 block around the head cell.
+     */
+    auto fruitUnderHead(const Entity& head, uint32_t head_cell) const -> std::optional<uint32_t> {
+        const sf::Rect head_collision = {head.position, head.size};
+
+        std::optional<uint32_t> fruit_cell;
+        m_grid.forEachNeighbourhoodCell(head_cell, [&](uint32_t cell) {
+            if (!fruit_cell &&
+                m_grid.hasFlag(cell, OccupancyGrid::Fruit) &&
+                checkCollision(head_collision, {m_grid.cellCenter(cell), {snek::TILE_SIZE, snek::TILE_SIZE}})) {
+                fruit_cell = cell;
             }
+        });
+
+        return fruit_cell;
+    }
+
+    /**
+     * @brief The player's snake is snake 0 of the body hash, arena snake i is snake i + 1.
+     */
+    auto snakeAt(uint32_t index) const -> const Snake& {
+        return index == 0u ? m_snake : m_arena[index - 1u];
+    }
+
+    auto headCellOf(const Snake& snake) const -> std::optional<uint32_t> {
+        if (snake.getMovement() == Snake::Movement::Grid) {
+            return gridCellOf(snake.getCells().fromHead(0u).position);
         }
 
-        for (const auto& rock : m_rocks) {
-            const auto [dx, dy] = rock.position - head.position;
+        return m_grid.cellAt(snake.getHeadPosition());
+    }
+
+    /**
+     * @brief Runs fn(i) for every arena snake, on the pool when there is one.
+     */
+    template<typename Fn>
+    auto forEachArenaSnake(Fn&& fn) -> void {
+        const auto count = static_cast<uint32_t>(m_arena.size());
 
-            if (std::abs(dx) > TILE_SIZE || std::abs(dy) > TILE_SIZE) {
-                continue; // skip distant rocks
+        if (m_pool == nullptr) {
+            for (uint32_t i = 0u; i < count; i++) {
+                fn(i);
             }
 
-            if (checkCollision(head_collision, {rock.position, rock.size})) {
-                SoundSystem::Play(RESPATH_DEATH_WAV);
-                m_state = State::GameOver;
+            return;
+        }
+
+        m_pool->parallelFor(count, [&fn](uint64_t i, uint32_t) {
+            fn(static_cast<uint32_t>(i));
+        });
+    }
 
-                return;
+    /**
+     * @brief Places the arena snakes one by one, each avoiding the ones placed before.
+     */
+    auto spawnArena(uint32_t count) -> void {
+        m_arena.reserve(count);
+        m_arena_verdicts.assign(count, DeathCause::None);
+        m_bodies.resize(count + 1u);
+
+        m_body_hash.clear((count + 1u) * static_cast<size_t>(SNAKE_INITIAL_LENGTH));
+        insertBody(0u);
+
+        for (uint32_t i = 0u; i < count; i++) {
+            m_arena.emplace_back(SNAKE_INITIAL_LENGTH, findArenaSpawn(), m_snake.getMovement());
+            insertBody(i + 1u);
+        }
+    }
+
+    /**
+     * @brief Head position for a new arena snake, its body hangs straight down from there.
+     *
+     * Tries a few random free cells for one with room for the body and a free cell ahead,
+     * then settles for the last candidate like spawnFruit() does. A snake spawned in a bad
+     * spot just dies and respawns on the next tick.
+     */
+    auto findArenaSpawn() -> sf::Vector2f {
+        constexpr uint32_t MAX_SPAWN_ATTEMPTS = 16u;
+
+        const uint32_t free_count = m_grid.getFreeCellCount();
+        if (free_count == 0u) {
+            return middleCellCenter(m_width, m_height);
+        }
+
+        std::uniform_int_distribution<uint32_t> dist(0u, free_count - 1u);
+
+        uint32_t idx = m_grid.getFreeCell(dist(m_rng));
+        for (uint32_t attempt = 1u; attempt < MAX_SPAWN_ATTEMPTS && !hasRoomForSnake(idx); attempt++) {
+            idx = m_grid.getFreeCell(dist(m_rng));
+        }
+
+        return m_grid.cellCenter(idx);
+    }
+
+    auto hasRoomForSnake(uint32_t head_cell) const -> bool {
+        const auto head = m_grid.cellCoords(head_cell);
+        const auto x = static_cast<int32_t>(head.x);
+
+        for (int32_t i = -1; i < static_cast<int32_t>(SNAKE_INITIAL_LENGTH); i++) {
+            const auto y = static_cast<int32_t>(head.y) + i;
+
+            if (!m_grid.contains(x, y)) {
+                return false;
+            }
+
+            const auto cell = m_grid.cellIndex(head.x, static_cast<uint32_t>(y));
+            if (m_grid.isOccupied(cell) || m_body_hash.contains(cell)) {
+                return false;
             }
         }
 
-        // Check collision with borders
-        if (head.position.x < 0.f ||
-            head.position.x > m_width * snek::TILE_SIZE ||
-            head.position.y < 0.f ||
-            head.position.y > m_height * snek::TILE_SIZE) {
-            SoundSystem::Play(RESPATH_DEATH_WAV);
-            m_state = State::GameOver;
+        return true;
+    }
+
+    /**
+     * @brief Adds every on-board segment of the index-th snake to the body hash.
+     */
+    auto insertBody(uint32_t index) -> void {
+        const auto& snake = snakeAt(index);
+        auto& body = m_bodies[index];
+
+        if (snake.getMovement() == Snake::Movement::Grid) {
+            // Straight from the cell ring, the segment entities would need materializing
+            const auto& cells = snake.getCells();
+            body.ids.assign(cells.getCapacity(), SpatialHash::NONE);
+
+            for (uint32_t seq = cells.getTailSeq(); seq != cells.getHeadSeq() + 1u; seq++) {
+                insertCell(index, seq);
+            }
+
+            body.tailSeq = cells.getTailSeq();
+            body.headSeq = cells.getHeadSeq();
+            body.capacity = cells.getCapacity();
+            body.enteredFrom = body.headSeq;
+
+            return;
+        }
+
+        const auto segments = snake.getEntities();
+        body.ids.assign(segments.size(), SpatialHash::NONE);
+
+        for (uint32_t i = 0u; i < segments.size(); i++) {
+            if (const auto cell = m_grid.cellAt(segments[i].position)) {
+                body.ids[i] = m_body_hash.insert(*cell, index, i, segments[i].position);
+            }
+        }
+    }
+
+    /**
+     * @brief Grid mode: adds the ring entry seq of the index-th snake to the body hash.
+     */
+    auto insertCell(uint32_t index, uint32_t seq) -> void {
+        const auto& cells = snakeAt(index).getCells();
+        const auto position = cells.at(seq).position;
+        auto& id = m_bodies[index].ids[cells.slotOf(seq)];
+
+        const auto cell = gridCellOf(position);
+        id = cell ? m_body_hash.insert(*cell, index, seq, Snake::cellCenter(position)) : SpatialHash::NONE;
+    }
+
+    auto removeBody(uint32_t index) -> void {
+        auto& body = m_bodies[index];
+
+        for (const auto id : body.ids) {
+            if (id != SpatialHash::NONE) {
+                m_body_hash.remove(id);
+            }
+        }
+
+        body.ids.clear();
+    }
+
+    /**
+     * @brief Brings the index-th snake's hash entries up to date after it moved.
+     *
+     * Grid mode costs O(1) per cell stepped however long the snake is: released tail cells
+     * leave the hash and entered ones join it. Free-mode segments all move every tick, each
+     * entry is moved along and relinked only when its segment crossed into another cell.
+     */
+    auto syncBody(uint32_t index) -> void {
+        const auto& snake = snakeAt(index);
+        auto& body = m_bodies[index];
+
+        if (snake.getMovement() == Snake::Movement::Grid) {
+            const auto& cells = snake.getCells();
+            const auto entered_from = body.headSeq;
+
+            if (cells.getCapacity() != body.capacity) {
+                // The ring reallocated and slots moved, the body starts over
+                removeBody(index);
+                insertBody(index);
+            } else {
+                for (uint32_t seq = body.tailSeq; seq != cells.getTailSeq(); seq++) {
+                    auto& id = body.ids[cells.slotOf(seq)];
+
+                    if (id != SpatialHash::NONE) {
+                        m_body_hash.remove(id);
+                        id = SpatialHash::NONE;
+                    }
+                }
+
+                for (uint32_t seq = body.headSeq + 1u; seq != cells.getHeadSeq() + 1u; seq++) {
+                    insertCell(index, seq);
+                }
+
+                body.tailSeq = cells.getTailSeq();
+                body.headSeq = cells.getHeadSeq();
+            }
+
+            body.enteredFrom = entered_from;
+
+            return;
+        }
+
+        const auto segments = snake.getEntities();
+
+        for (uint32_t i = 0u; i < segments.size(); i++) {
+            const auto cell = m_grid.cellAt(segments[i].position);
+            auto& id = body.ids[i];
+
+            if (!cell) {
+                if (id != SpatialHash::NONE) {
+                    m_body_hash.remove(id);
+                    id = SpatialHash::NONE;
+                }
+            } else if (id == SpatialHash::NONE) {
+                id = m_body_hash.insert(*cell, index, i, segments[i].position);
+            } else {
+                m_body_hash.move(id, *cell, segments[i].position);
+            }
+        }
+    }
+
+    /**
+     * @brief Free mode: adds the segments the index-th snake just grew, grid-mode growth
+     *        shows up as entered cells on the next move.
+     */
+    auto insertGrowth(uint32_t index) -> void {
+        if (index >= m_bodies.size() || snakeAt(index).getMovement() == Snake::Movement::Grid) {
+            return;
+        }
+
+        const auto segments = snakeAt(index).getEntities();
+        auto& body = m_bodies[index];
+
+        for (auto i = static_cast<uint32_t>(body.ids.size()); i < segments.size(); i++) {
+            const auto cell = m_grid.cellAt(segments[i].position);
+            body.ids.push_back(cell ? m_body_hash.insert(*cell, index, i, segments[i].position) : SpatialHash::NONE);
+        }
+    }
+
+    /**
+     * @brief Hashes every snake's body from scratch.
+     */
+    auto rebuildBodyHash() -> void {
+        m_body_hash.clear(getEntityCount() - m_fruits.size() - m_rocks.size());
+
+        for (uint32_t index = 0u; index <= m_arena.size(); index++) {
+            insertBody(index);
+        }
+    }
+
+    /**
+     * @brief Moves every arena snake, then brings the body hash up to date with all snakes.
+     *
+     * Moving runs in parallel, each snake only writes its own state. The hash is synced in
+     * snake order, so its layout doesn't depend on the pool or its thread count.
+     */
+    auto moveArena(std::span<const InputAction> actions) -> void {
+        SNEK_PROFILE_SCOPE("Board::moveArena");
+
+        forEachArenaSnake([&](uint32_t i) {
+            auto& snake = m_arena[i];
+            const auto action = i < actions.size() ? actions[i] : InputAction::None;
+
+            if (action == InputAction::TurnLeft) {
+                snake.turnLeft();
+            } else if (action == InputAction::TurnRight) {
+                snake.turnRight();
+            }
+
+            snake.move(m_tick_duration);
+        });
+
+        for (uint32_t index = 0u; index <= m_arena.size(); index++) {
+            syncBody(index);
+        }
+    }
+
+    /**
+     * @brief Resolves the collisions between all snakes after moveArena() and the player's tick.
+     *
+     * Heads are checked in parallel. Everything touching the rest of the board (deaths,
+     * fruit, respawns, the RNG) is resolved in snake order, so the outcome doesn't depend
+     * on the pool or its thread count. A fruit with no free cell left to respawn on wins
+     * the game, whichever snake ate it.
+     */
+    auto resolveArena() -> void {
+        SNEK_PROFILE_SCOPE("Board::resolveArena");
+
+        forEachArenaSnake([&](uint32_t i) {
+            m_arena_verdicts[i] = checkHead(i + 1u);
+        });
+
+        // Own collisions of the player's snake were handled by update() already
+        if (checkHead(0u) != DeathCause::None) {
+            die(DeathCause::Rival);
+        }
+
+        for (uint32_t i = 0u; i < m_arena.size(); i++) {
+            if (m_arena_verdicts[i] != DeathCause::None) {
+                m_arena_deaths++;
+
+                removeBody(i + 1u);
+                m_arena[i] = Snake(SNAKE_INITIAL_LENGTH, findArenaSpawn(), m_snake.getMovement());
+                insertBody(i + 1u);
+
+                continue;
+            }
+
+            auto& snake = m_arena[i];
+            const auto head_cell = headCellOf(snake);
+
+            const auto eaten_cell = snake.getMovement() == Snake::Movement::Grid
+                ? (m_grid.hasFlag(*head_cell, OccupancyGrid::Fruit) ? head_cell : std::nullopt)
+                : fruitUnderHead(snake.getHead(), *head_cell);
+
+            if (eaten_cell) {
+                // Lower indices resolve first, so they win a fruit two heads reached at once
+                m_fruits.erase(m_grid.cellCenter(*eaten_cell));
+                m_grid.clearFlag(*eaten_cell, OccupancyGrid::Fruit);
+
+                snake.grow();
+                insertGrowth(i + 1u);
+
+                // The snakes fill the board between them. The rest still resolve and a rival
+                // may have killed the player this tick already, that death stands.
+                if (!spawnFruit() && m_state == State::Playing) {
+                    m_state = State::Won;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief What the index-th snake's head ran into this tick, reads shared state only.
+     *
+     * Head to head, the shorter snake dies, both when they're as long. The player's snake
+     * is only checked against the other snakes.
+     */
+    auto checkHead(uint32_t index) const -> DeathCause {
+        const auto& snake = snakeAt(index);
+        const auto head_cell = headCellOf(snake);
+
+        if (!head_cell) {
+            return index == 0u ? DeathCause::None : DeathCause::Wall;
+        }
+
+        const auto length = snake.getLength();
+        bool rock = false;
+        bool self = false;
+        bool rival = false;
+
+        // own_skipped: an own segment the head always touches, rival_head: another snake's head
+        const auto hit = [&](const SpatialHash::Entry& entry, bool own_skipped, bool rival_head) {
+            if (entry.snake == index) {
+                self = self || !own_skipped;
+            } else {
+                rival = rival || !rival_head || length <= snakeAt(entry.snake).getLength();
+            }
+        };
+
+        if (snake.getMovement() == Snake::Movement::Grid) {
+            // Grid-mode segments never leave their cell, sharing it is a collision. Every cell
+            // the head entered during the last move is checked, the head's own one when none.
+            const auto& cells = snake.getCells();
+            const auto head_seq = cells.getHeadSeq();
+            const auto entered_from = m_bodies[index].enteredFrom;
+
+            for (uint32_t seq = entered_from == head_seq ? head_seq : entered_from + 1u; seq != head_seq + 1u; seq++) {
+                // A move is straight, cells past the edge come last and the head's was checked above
+                const auto cell = gridCellOf(cells.at(seq).position);
+                if (!cell) {
+                    continue;
+                }
+
+                rock = rock || m_grid.hasFlag(*cell, OccupancyGrid::Rock);
+
+                m_body_hash.forEachIn(*cell, [&](const SpatialHash::Entry& entry) {
+                    hit(entry, entry.segment == seq, entry.segment == snakeAt(entry.snake).getCells().getHeadSeq());
+                });
+            }
+        } else {
+            // Same shrunk head as handle_collision(), the segment right behind always touches
+            constexpr float COLLISION_SHRINK_FACTOR = 0.4f;
+            const auto& head = snake.getHead();
+            const sf::Rect shrunk_collision = {
+                head.position + head.size * COLLISION_SHRINK_FACTOR / 2.f,
+                head.size * (1.f - COLLISION_SHRINK_FACTOR)
+            };
+
+            m_grid.forEachNeighbourhoodCell(*head_cell, [&](uint32_t cell) {
+                rock = rock || (m_grid.hasFlag(cell, OccupancyGrid::Rock) &&
+                    checkCollision(shrunk_collision, {m_grid.cellCenter(cell), {snek::TILE_SIZE, snek::TILE_SIZE}}));
+
+                m_body_hash.forEachIn(cell, [&](const SpatialHash::Entry& entry) {
+                    if (checkCollision(shrunk_collision, {entry.position, {snek::TILE_SIZE, snek::TILE_SIZE}})) {
+                        hit(entry, entry.segment < 2u, entry.segment == 0u);
+                    }
+                });
+            });
+        }
+
+        if (index == 0u) {
+            return rival ? DeathCause::Rival : DeathCause::None;
+        }
+
+        if (rock) {
+            return DeathCause::Rock;
+        }
+
+        if (self) {
+            return DeathCause::Self;
         }
+
+        return rival ? DeathCause::Rival : DeathCause::None;
+    }
+
+    auto cacheRockState() -> void {
+        m_rock_state.clear();
+
+        StateWriter writer{m_rock_state};
+        m_rocks.saveState(writer);
+    }
+
+    static auto readStateHeader(StateReader& reader, size_t size) -> std::optional<StateHeader> {
+        StateHeader header{};
+
+        const bool valid = reader.get(header) && header.magic == STATE_MAGIC && header.version == STATE_VERSION &&
+            header.byteCount == size && header.movement <= Snake::Movement::Grid;
+        if (!valid) {
+            std::println(stderr, "Not a board state of version {}", STATE_VERSION);
+
+            return std::nullopt;
+        }
+
+        return header;
+    }
+
+    /**
+     * @brief Everything past the header of saveState(), in the same order.
+     *
+     * Reads into locals and the m_restored_* copies first, the board only changes once
+     * all of the state checks out.
+     */
+    auto restoreBody(StateReader& reader) -> bool {
+        State state{};
+        DeathCause death_cause{};
+        std::array<InputAction, INPUT_TURN_BUFFER_MAX> turns{};
+        uint32_t turn_count = 0u;
+        uint64_t turns_taken = 0u;
+        uint64_t turns_dropped = 0u;
+        Camera camera;
+
+        reader.get(state);
+        reader.get(death_cause);
+        reader.get(turns);
+        reader.get(turn_count);
+        reader.get(turns_taken);
+        reader.get(turns_dropped);
+        const auto rng = reader.getBytes(sizeof(m_rng)); // any state is valid, read in place once applied
+        reader.get(camera);
+
+        if (!m_restored_snake) {
+            m_restored_snake = m_snake;
+        }
+        if (!m_restored_fruits) {
+            m_restored_fruits = m_fruits;
+        }
+        if (m_restored_arena.size() != m_arena.size()) {
+            m_restored_arena = m_arena;
+        }
+
+        const bool scalars_valid = state <= State::Won && death_cause <= DeathCause::Rival && turn_count <= turns.size();
+        if (!scalars_valid || !m_restored_snake->restoreState(reader)) {
+            return discardRestore();
+        }
+
+        uint32_t rock_bytes = 0u;
+        reader.get(rock_bytes);
+        const auto rocks = reader.getBytes(rock_bytes);
+
+        // Other rocks are another level, read aside like the rest
+        std::optional<EntityChunks> level_rocks;
+        if (!reader.failed() && !std::ranges::equal(rocks, m_rock_state)) {
+            level_rocks = readRocks(rocks);
+
+            if (!level_rocks) {
+                return discardRestore();
+            }
+        }
+
+        if (reader.failed() || !m_restored_fruits->restoreState(reader) || !onBoard(*m_restored_fruits)) {
+            return discardRestore();
+        }
+
+        uint64_t arena_deaths = 0u;
+        reader.get(arena_deaths);
+        for (auto& snake : m_restored_arena) {
+            if (!snake.restoreState(reader)) {
+                return discardRestore();
+            }
+        }
+
+        if (reader.remaining() != 0u) {
+            return discardRestore();
+        }
+
+        // All of it checks out, nothing fails past here.
+        // The fruits' flags leave with them, the rocks' stay unless the rocks differ.
+        m_fruits.forEach([&](const Entity& fruit) {
+            if (const auto cell = m_grid.cellAt(fruit.position)) {
+                m_grid.clearFlag(*cell, OccupancyGrid::Fruit);
+            }
+        });
+
+        if (level_rocks) {
+            m_grid = OccupancyGrid{m_width, m_height};
+            m_rocks = std::move(*level_rocks);
+            setFlags(m_rocks, OccupancyGrid::Rock);
+
+            m_rock_state.assign(rocks.begin(), rocks.end());
+            m_level_id = nextLevelId();
+        }
+
+        m_state = state;
+        m_death_cause = death_cause;
+        m_turns = turns;
+        m_turn_count = turn_count;
+        m_turns_taken = turns_taken;
+        m_turns_dropped = turns_dropped;
+        StateReader{rng}.get(m_rng);
+        m_camera = camera;
+        m_arena_deaths = arena_deaths;
+
+        std::swap(m_snake, *m_restored_snake);
+        std::swap(m_fruits, *m_restored_fruits);
+        std::swap(m_arena, m_restored_arena);
+
+        setFlags(m_fruits, OccupancyGrid::Fruit);
+
+        if (m_snake.getMovement() == Snake::Movement::Grid) {
+            linkGridSnake();
+        } else {
+            m_grid.clearSegments();
+            syncSnakeCells();
+        }
+
+        // The hash's layout isn't state, only which segments lie where
+        if (!m_arena.empty()) {
+            rebuildBodyHash();
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Drops the restore copies, a failed read may leave them inconsistent.
+     *
+     * @return false, for restoreBody() to return.
+     */
+    auto discardRestore() -> bool {
+        m_restored_snake.reset();
+        m_restored_fruits.reset();
+        m_restored_arena.clear();
+
+        return false;
+    }
+
+    /**
+     * @return The rocks of another level, or nothing when they're corrupted or off the board.
+     */
+    auto readRocks(std::span<const uint8_t> rocks) const -> std::optional<EntityChunks> {
+        StateReader reader{rocks};
+        EntityChunks chunks{m_width, m_height};
+
+        if (!chunks.restoreState(reader) || reader.remaining() != 0u || !onBoard(chunks)) {
+            return std::nullopt;
+        }
+
+        return chunks;
+    }
+
+    auto onBoard(const EntityChunks& entities) const -> bool {
+        bool on_board = true;
+
+        entities.forEach([&](const Entity& entity) {
+            on_board = on_board && m_grid.cellAt(entity.position).has_value();
+        });
+
+        return on_board;
+    }
+
+    /**
+     * @brief Flags the cells of entities known to lie on the board, see onBoard().
+     */
+    auto setFlags(const EntityChunks& entities, OccupancyGrid::Flag flag) -> void {
+        entities.forEach([&](const Entity& entity) {
+            if (const auto cell = m_grid.cellAt(entity.position)) {
+                m_grid.setFlag(*cell, flag);
+            }
+        });
     }
 }; // class Board
 
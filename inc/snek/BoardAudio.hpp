@@ -0,0 +1,31 @@
+/**
+ * @file BoardAudio.hpp
+ * 
+ * @brief Board listener playing sound effects for simulation events.
+ */
+#pragma once
+
+#include "snek/Board.hpp"
+#include "snek/SoundSystem.hpp"
+#include "snek/constants.hpp"
+
+namespace snek {
+
+class BoardAudio final : public IBoardListener {
+public:
+    auto onBoardEvent(BoardEvent event) -> void override {
+        switch (event) {
+            case BoardEvent::Turned:
+                SoundSystem::Play(SoundId::Turn);
+                break;
+            case BoardEvent::FruitEaten:
+                SoundSystem::Play(SoundId::Eat);
+                break;
+            case BoardEvent::SnakeDied:
+                SoundSystem::Play(SoundId::Death);
+                break;
+        }
+    }
+}; // class BoardAudio
+
+} // namespace snek
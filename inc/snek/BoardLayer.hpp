@@ -0,0 +1,71 @@
+/**
+ * @file BoardLayer.hpp
+ * 
+ * @brief Layer presenting a Board in the window, the rendering observer of the simulation.
+ * 
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include "snek/ILayer.hpp"
+#include "snek/Board.hpp"
+#include "snek/Replay.hpp"
+#include "snek/StaticLayer.hpp"
+
+namespace snek {
+
+class BoardLayer final : public ILayer {
+public:
+    explicit BoardLayer(Board& board)
+        : m_board(board)
+    {}
+
+    auto update(InputAction action) -> void override {
+        // Ticks of a finished game change nothing, they are left out of the recording
+        if (m_recorder != nullptr && m_board.getState() == Board::State::Playing) {
+            m_recorder->record(m_board, action);
+        }
+
+        m_board.update(action);
+    }
+
+    /**
+     * @brief Records every tick fed to the board from now on, nullptr stops recording.
+     */
+    auto setRecorder(ReplayRecorder* recorder) -> void {
+        m_recorder = recorder;
+    }
+
+    /**
+     * @brief Draws what the board's camera sees, nothing outside its chunks is visited.
+     *
+     * Floor and rocks come from the baked static layer, rebuilt only when the level changes,
+     * the snake and fruits are batched every frame on top of it.
+     */
+    auto render(Renderer& renderer) const -> void override {
+        const auto& camera = m_board.getCamera();
+        const auto area = camera.getViewRect(renderer.getInterpolation());
+
+        renderer.setView(sf::View{area});
+
+        if (!m_static_layer.isBuiltFor(m_board)) {
+            m_static_layer.build(m_board);
+        }
+        m_static_layer.draw(renderer, area);
+
+        m_board.forEachDynamicEntityIn(area, [&](const Entity& entity) {
+            renderer.draw(&entity);
+        });
+    }
+
+    auto getBoard() const -> const Board& {
+        return m_board;
+    }
+private:
+    Board& m_board;
+    ReplayRecorder* m_recorder{nullptr};
+
+    mutable StaticLayer m_static_layer; // a cache of the board, filled lazily while rendering
+}; // class BoardLayer
+
+} // namespace snek
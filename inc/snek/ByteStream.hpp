@@ -0,0 +1,164 @@
+/**
+ * @file ByteStream.hpp
+ *
+ * @brief Little-endian byte writer and reader for the binary file formats.
+ *
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <cstdio>
+#include <print>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace snek {
+
+class ByteWriter {
+public:
+    template<std::unsigned_integral T>
+    auto put(T value) -> void {
+        for (size_t i = 0u; i < sizeof(T); i++) {
+            m_bytes.push_back(static_cast<uint8_t>(value >> (8u * i)));
+        }
+    }
+
+    auto putFloat(float value) -> void {
+        put(std::bit_cast<uint32_t>(value));
+    }
+
+    /**
+     * @brief LEB128, 7 bits per byte, small values take a single byte.
+     */
+    auto putVarint(uint64_t value) -> void {
+        while (value >= 0x80u) {
+            m_bytes.push_back(static_cast<uint8_t>(value | 0x80u));
+            value >>= 7u;
+        }
+
+        m_bytes.push_back(static_cast<uint8_t>(value));
+    }
+
+    auto putBytes(std::span<const uint8_t> bytes) -> void {
+        m_bytes.insert(m_bytes.end(), bytes.begin(), bytes.end());
+    }
+
+    auto getBytes() const -> std::span<const uint8_t> {
+        return m_bytes;
+    }
+
+    auto clear() -> void {
+        m_bytes.clear();
+    }
+
+    auto writeFile(std::string_view path) const -> bool {
+        std::FILE* file = std::fopen(std::string(path).c_str(), "wb");
+        if (file == nullptr) {
+            std::println(stderr, "Failed to open {} for writing", path);
+
+            return false;
+        }
+
+        const bool written = std::fwrite(m_bytes.data(), 1u, m_bytes.size(), file) == m_bytes.size();
+        std::fclose(file);
+
+        if (!written) {
+            std::println(stderr, "Failed to write {}", path);
+        }
+
+        return written;
+    }
+private:
+    std::vector<uint8_t> m_bytes;
+}; // class ByteWriter
+
+/**
+ * @brief Reads what ByteWriter wrote. Reading past the end yields zeros and marks the reader failed.
+ */
+class ByteReader {
+public:
+    explicit ByteReader(std::span<const uint8_t> bytes)
+        : m_bytes(bytes)
+    {}
+
+    template<std::unsigned_integral T>
+    auto get() -> T {
+        if (m_bytes.size() - m_pos < sizeof(T)) {
+            m_failed = true;
+            m_pos = m_bytes.size();
+
+            return T{0};
+        }
+
+        T value{0};
+        for (size_t i = 0u; i < sizeof(T); i++) {
+            value |= static_cast<T>(static_cast<T>(m_bytes[m_pos++]) << (8u * i));
+        }
+
+        return value;
+    }
+
+    auto getFloat() -> float {
+        return std::bit_cast<float>(get<uint32_t>());
+    }
+
+    auto getVarint() -> uint64_t {
+        uint64_t value = 0u;
+
+        for (uint32_t shift = 0u; shift < 64u; shift += 7u) {
+            const auto byte = get<uint8_t>();
+            value |= static_cast<uint64_t>(byte & 0x7Fu) << shift;
+
+            if ((byte & 0x80u) == 0u) {
+                return value;
+            }
+        }
+
+        m_failed = true;
+
+        return value;
+    }
+
+    auto remaining() const -> size_t {
+        return m_bytes.size() - m_pos;
+    }
+
+    auto failed() const -> bool {
+        return m_failed;
+    }
+private:
+    std::span<const uint8_t> m_bytes;
+    size_t m_pos{0u};
+    bool m_failed{false};
+}; // class ByteReader
+
+/**
+ * @brief Reads a whole file into out, false (reported on stderr) when it can't be opened.
+ */
+inline auto readFile(std::string_view path, std::vector<uint8_t>& out) -> bool {
+    std::FILE* file = std::fopen(std::string(path).c_str(), "rb");
+    if (file == nullptr) {
+        std::println(stderr, "Failed to open {}", path);
+
+        return false;
+    }
+
+    out.clear();
+
+    uint8_t chunk[4096];
+    size_t read = 0u;
+    while ((read = std::fread(chunk, 1u, sizeof(chunk), file)) > 0u) {
+        out.insert(out.end(), chunk, chunk + read);
+    }
+
+    std::fclose(file);
+
+    return true;
+}
+
+} // namespace snek
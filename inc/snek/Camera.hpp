@@ -0,0 +1,80 @@
+/**
+ * @file Camera.hpp
+ *
+ * @brief Camera following a point over the board, clamped so it never shows past the edges.
+ *
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <algorithm>
+
+namespace snek {
+
+class Camera {
+public:
+    Camera() = default;
+
+    /**
+     * @param viewSize Visible area in board pixels.
+     * @param boardSize Whole board in board pixels.
+     */
+    Camera(sf::Vector2f viewSize, sf::Vector2f boardSize)
+        : m_view_size(viewSize)
+        , m_board_size(boardSize)
+        , m_center(boardSize / 2.f)
+        , m_previous_center(m_center)
+    {}
+
+    /**
+     * @brief Centers the view on the target as far as the board edges allow, once per tick.
+     */
+    auto follow(sf::Vector2f target) -> void {
+        m_previous_center = m_center;
+        m_center = {clampAxis(target.x, m_view_size.x, m_board_size.x), clampAxis(target.y, m_view_size.y, m_board_size.y)};
+    }
+
+    /**
+     * @brief Moves to the target at once, the next interpolated frame doesn't pan there.
+     */
+    auto snapTo(sf::Vector2f target) -> void {
+        follow(target);
+        m_previous_center = m_center;
+    }
+
+    /**
+     * @brief Center between the last two ticks, alpha as for interpolated entities.
+     */
+    auto getCenter(float alpha = 1.f) const -> sf::Vector2f {
+        return m_previous_center + (m_center - m_previous_center) * alpha;
+    }
+
+    auto getViewSize() const -> sf::Vector2f {
+        return m_view_size;
+    }
+
+    /**
+     * @brief Board area the camera shows, in board pixels.
+     */
+    auto getViewRect(float alpha = 1.f) const -> sf::FloatRect {
+        return {getCenter(alpha) - m_view_size / 2.f, m_view_size};
+    }
+private:
+    static auto clampAxis(float target, float view, float board) -> float {
+        if (view >= board) {
+            return board / 2.f; // the whole axis fits, keep it centered
+        }
+
+        return std::clamp(target, view / 2.f, board - view / 2.f);
+    }
+
+    sf::Vector2f m_view_size;
+    sf::Vector2f m_board_size;
+    sf::Vector2f m_center;
+    sf::Vector2f m_previous_center;
+}; // class Camera
+
+} // namespace snek
@@ -0,0 +1,137 @@
+/**
+ * @file CellRing.hpp
+ * 
+ * @brief Growable ring buffer of grid cells addressed by sequence numbers, backing the grid-mode snake.
+ * 
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+#include "snek/Entity.hpp"
+#include "snek/StateStream.hpp"
+
+namespace snek {
+
+/**
+ * @brief Head/tail deque of cells with O(1) push at the head and pop at the tail.
+ *
+ * Entries are addressed by a monotonically increasing sequence number, the live ones
+ * are [getTailSeq(), getHeadSeq()]. The slot of an entry, seq & mask, stays the same
+ * for the entry's lifetime unless the ring grows, which getCapacity() reveals.
+ */
+class CellRing {
+public:
+    struct Cell {
+        sf::Vector2i position;
+        Direction direction; // direction the snake was heading when it entered the cell
+    };
+
+    auto size() const -> uint32_t {
+        return m_head_seq + 1u - m_tail_seq;
+    }
+
+    auto empty() const -> bool {
+        return size() == 0u;
+    }
+
+    auto getCapacity() const -> uint32_t {
+        return static_cast<uint32_t>(m_cells.size());
+    }
+
+    auto getHeadSeq() const -> uint32_t {
+        return m_head_seq;
+    }
+
+    auto getTailSeq() const -> uint32_t {
+        return m_tail_seq;
+    }
+
+    auto slotOf(uint32_t seq) const -> uint32_t {
+        return seq & m_mask;
+    }
+
+    auto at(uint32_t seq) const -> const Cell& {
+        return m_cells[seq & m_mask];
+    }
+
+    /**
+     * @brief Entry index cells behind the head, 0 being the head itself.
+     */
+    auto fromHead(uint32_t index) const -> const Cell& {
+        return at(m_head_seq - index);
+    }
+
+    auto pushHead(const Cell& cell) -> void {
+        if (size() == m_cells.size()) {
+            grow();
+        }
+
+        m_head_seq++;
+        m_cells[m_head_seq & m_mask] = cell;
+    }
+
+    /**
+     * @brief Appends behind the tail, used when building the initial body.
+     */
+    auto pushTail(const Cell& cell) -> void {
+        if (size() == m_cells.size()) {
+            grow();
+        }
+
+        m_tail_seq--;
+        m_cells[m_tail_seq & m_mask] = cell;
+    }
+
+    auto popTail() -> void {
+        m_tail_seq++;
+    }
+
+    auto saveState(StateWriter& writer) const -> void {
+        writer.putArray<Cell>(m_cells);
+        writer.put(m_tail_seq);
+        writer.put(m_head_seq);
+    }
+
+    /**
+     * @return false when the state doesn't describe a valid ring.
+     */
+    auto restoreState(StateReader& reader) -> bool {
+        if (!reader.getArray(m_cells) || !reader.get(m_tail_seq) || !reader.get(m_head_seq)) {
+            return false;
+        }
+
+        m_mask = m_cells.empty() ? 0u : static_cast<uint32_t>(m_cells.size() - 1u);
+
+        const bool power_of_two = m_cells.empty() || std::has_single_bit(m_cells.size());
+
+        return power_of_two && size() <= m_cells.size();
+    }
+private:
+    auto grow() -> void {
+        std::vector<Cell> cells(std::max<size_t>(m_cells.size() * 2u, 16u));
+        const auto mask = static_cast<uint32_t>(cells.size() - 1u);
+
+        for (uint32_t seq = m_tail_seq; seq != m_head_seq + 1u; seq++) {
+            cells[seq & mask] = at(seq);
+        }
+
+        m_cells = std::move(cells);
+        m_mask = mask;
+    }
+
+    std::vector<Cell> m_cells;
+    uint32_t m_mask{0u};
+
+    // Empty when head + 1 == tail
+    uint32_t m_tail_seq{0u};
+    uint32_t m_head_seq{static_cast<uint32_t>(-1)};
+}; // class CellRing
+
+} // namespace snek
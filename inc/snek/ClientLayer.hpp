@@ -0,0 +1,166 @@
+/**
+ * @file ClientLayer.hpp
+ *
+ * @brief Layer playing on a snek_server, draws the server's snapshots and the predicted own snake.
+ *
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <SFML/Graphics/View.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "snek/Camera.hpp"
+#include "snek/constants.hpp"
+#include "snek/Entity.hpp"
+#include "snek/EntityChunks.hpp"
+#include "snek/ILayer.hpp"
+#include "snek/NetClient.hpp"
+#include "snek/StaticLayer.hpp"
+
+namespace snek {
+
+class ClientLayer final : public ILayer {
+public:
+    explicit ClientLayer(NetClient& client)
+        : m_client(client)
+    {}
+
+    /**
+     * @brief Sends the action and rebuilds the entities from what the server sent since.
+     */
+    auto update(InputAction action) -> void override {
+        m_client.tick(action);
+
+        const auto& welcome = m_client.getWelcome();
+        if (!welcome) {
+            return;
+        }
+
+        if (welcome->match != m_match) {
+            startMatch(*welcome);
+        }
+
+        const auto* state = m_client.getState();
+        if (state == nullptr) {
+            return;
+        }
+
+        m_snakes.resize(state->snakes.size());
+        for (uint32_t i = 0u; i < state->snakes.size(); i++) {
+            // The own snake is drawn where it's going to be, not where the server last saw it
+            const auto segments = i == welcome->slot ? m_client.getPredictedSnake() : std::span{state->snakes[i]};
+
+            updateSnake(m_snakes[i], segments);
+        }
+
+        m_fruits.clear();
+        for (const auto cell : state->fruits) {
+            Entity fruit;
+            fruit.position = Snake::cellCenter({static_cast<int32_t>(cell % welcome->width), static_cast<int32_t>(cell / welcome->width)});
+            fruit.previousPosition = fruit.position;
+            fruit.size = {TILE_SIZE, TILE_SIZE};
+            fruit.sprite = SpriteId::Fruit;
+            fruit.rotationOffsetDegrees = 90.f;
+
+            m_fruits.push_back(fruit);
+        }
+
+        if (welcome->slot < m_snakes.size() && !m_snakes[welcome->slot].empty()) {
+            m_camera.follow(m_snakes[welcome->slot].front().position);
+        }
+    }
+
+    auto render(Renderer& renderer) const -> void override {
+        const auto& welcome = m_client.getWelcome();
+        if (!welcome) {
+            renderer.resetView();
+            renderer.drawText({.text = m_connecting_text});
+
+            return;
+        }
+
+        const auto area = m_camera.getViewRect(renderer.getInterpolation());
+        renderer.setView(sf::View{area});
+
+        if (!m_static_layer.isBuiltFor(m_match)) {
+            m_static_layer.build(m_match, welcome->width, welcome->height, m_rocks);
+        }
+        m_static_layer.draw(renderer, area);
+
+        for (const auto& fruit : m_fruits) {
+            renderer.draw(&fruit);
+        }
+
+        for (const auto& snake : m_snakes) {
+            for (const auto& segment : snake) {
+                renderer.draw(&segment);
+            }
+        }
+    }
+private:
+    auto startMatch(const NetWelcome& welcome) -> void {
+        m_match = welcome.match;
+        m_snakes.clear();
+        m_fruits.clear();
+
+        m_rocks = EntityChunks{welcome.width, welcome.height};
+        for (const auto cell : welcome.rocks) {
+            Entity rock;
+            rock.position = Snake::cellCenter({static_cast<int32_t>(cell % welcome.width), static_cast<int32_t>(cell / welcome.width)});
+            rock.previousPosition = rock.position;
+            rock.size = {TILE_SIZE, TILE_SIZE};
+            rock.sprite = SpriteId::Rock;
+
+            m_rocks.insert(rock);
+        }
+
+        const auto board_size = sf::Vector2f{static_cast<float>(welcome.width), static_cast<float>(welcome.height)} * TILE_SIZE;
+        m_camera = Camera{
+            {std::min(welcome.width, CAMERA_VIEW_TILES_X) * TILE_SIZE, std::min(welcome.height, CAMERA_VIEW_TILES_Y) * TILE_SIZE},
+            board_size};
+    }
+
+    /**
+     * @brief Keeps the previous positions of segments that moved a little, so they're interpolated.
+     */
+    static auto updateSnake(std::vector<Entity>& entities, std::span<const NetSegment> segments) -> void {
+        const auto previous_count = entities.size();
+        entities.resize(segments.size());
+
+        for (size_t i = 0u; i < segments.size(); i++) {
+            auto& entity = entities[i];
+            const auto position = segments[i].getPosition();
+
+            const bool continues = i < previous_count &&
+                std::abs(entity.position.x - position.x) + std::abs(entity.position.y - position.y) < TILE_SIZE;
+
+            entity.previousPosition = continues ? entity.position : position;
+            entity.position = position;
+            entity.size = {TILE_SIZE, TILE_SIZE};
+            entity.direction = segments[i].direction;
+            entity.sprite = i == 0u ? SpriteId::SnakeHead : SpriteId::SnakeBody;
+            entity.rotationOffsetDegrees = i == 0u ? 90.f : 0.f;
+        }
+    }
+
+    NetClient& m_client;
+    uint32_t m_match{0u}; // doubles as the static layer's level id, matches start at 1
+
+    std::vector<std::vector<Entity>> m_snakes;
+    std::vector<Entity> m_fruits;
+    EntityChunks m_rocks;
+    Camera m_camera;
+
+    std::string m_connecting_text{"Connecting..."};
+
+    mutable StaticLayer m_static_layer;
+}; // class ClientLayer
+
+} // namespace snek
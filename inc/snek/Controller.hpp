@@ -0,0 +1,86 @@
+/**
+ * @file Controller.hpp
+ *
+ * @brief Interface of anything steering a Board instead of a player, plus the random bot.
+ *
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <random>
+
+#include "snek/Board.hpp"
+#include "snek/InputAction.hpp"
+
+namespace snek {
+
+/**
+ * @brief Picks the action of every tick, call decide(board) right before board.update(action).
+ *
+ * Controllers may keep state between ticks, one controller steers one board.
+ */
+struct IController {
+    virtual ~IController() = default;
+
+    virtual auto decide(const Board& board) -> InputAction = 0;
+};
+
+/**
+ * @brief Turns at random, one tick in 8 on average. Cheap, dies soon, good for fuzzing.
+ */
+class RandomController final : public IController {
+public:
+    explicit RandomController(uint32_t seed)
+        : m_rng(seed)
+    {}
+
+    auto decide(const Board&) -> InputAction override {
+        switch (m_rng() % 16u) {
+            case 0u: return InputAction::TurnLeft;
+            case 1u: return InputAction::TurnRight;
+            default: return InputAction::None;
+        }
+    }
+private:
+    std::mt19937 m_rng;
+}; // class RandomController
+
+/**
+ * @brief Action of a bot snake that turns when a wall or rock is right ahead, otherwise
+ * one tick in 16 at random.
+ *
+ * Works for any snake on the board, arena ones included, and only reads the board, so
+ * many snakes can decide in parallel with a generator each.
+ */
+inline auto wander(const Board& board, const Snake& snake, std::minstd_rand& rng) -> InputAction {
+    const auto& grid = board.getGrid();
+    const auto heading = snake.getHeading();
+    const auto offset = Snake::cellOffset(heading);
+
+    std::optional<uint32_t> ahead;
+    if (snake.getMovement() == Snake::Movement::Grid) {
+        const auto cell = snake.getCells().fromHead(0u).position + offset;
+
+        if (grid.contains(cell.x, cell.y)) {
+            ahead = grid.cellIndex(static_cast<uint32_t>(cell.x), static_cast<uint32_t>(cell.y));
+        }
+    } else {
+        ahead = grid.cellAt(snake.getHeadPosition() + sf::Vector2f(offset) * TILE_SIZE);
+    }
+
+    const auto roll = rng() % 16u;
+
+    if (!ahead || grid.hasFlag(*ahead, OccupancyGrid::Rock)) {
+        return roll % 2u == 0u ? InputAction::TurnLeft : InputAction::TurnRight;
+    }
+
+    switch (roll) {
+        case 0u: return InputAction::TurnLeft;
+        case 1u: return InputAction::TurnRight;
+        default: return InputAction::None;
+    }
+}
+
+} // namespace snek
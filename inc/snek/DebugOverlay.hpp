@@ -0,0 +1,124 @@
+/**
+ * @file DebugOverlay.hpp
+ * 
+ * @brief Aggregated, paged debug overlay of a Board drawn through the Renderer's cached text slots.
+ * 
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <SFML/Graphics/VertexArray.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include "snek/Board.hpp"
+#include "snek/InputLatency.hpp"
+#include "snek/Renderer.hpp"
+
+namespace snek {
+
+class DebugOverlay {
+public:
+    static constexpr uint32_t SEGMENTS_PER_PAGE = 16u;
+
+    auto nextPage() -> void {
+        m_page++;
+    }
+
+    /**
+     * @brief Draws a summary of the board plus one page of snake segments.
+     *
+     * @param frame_seconds Duration of the previous frame.
+     */
+    auto render(Renderer& renderer, const Board& board, const InputLatency& latency, float frame_seconds) -> void {
+        renderer.resetView();
+
+        m_frame_ms[m_frame_cursor] = frame_seconds * 1000.f;
+        m_frame_cursor = (m_frame_cursor + 1u) % GRAPH_FRAMES;
+        renderFrameGraph(renderer);
+
+        const auto& snake = board.getSnake();
+        const auto& head = snake.getHead();
+        const auto length = static_cast<uint32_t>(snake.getLength());
+
+        const uint32_t page_count = (length + SEGMENTS_PER_PAGE - 1u) / SEGMENTS_PER_PAGE;
+        const uint32_t page = m_page % std::max(page_count, 1u);
+        const uint32_t first = page * SEGMENTS_PER_PAGE;
+        const uint32_t last = std::min(first + SEGMENTS_PER_PAGE, length);
+
+        renderer.cachedText(0u, lineProps(0u), "Frame: {:.2f} ms  Draw calls: {}",
+            frame_seconds * 1000.f, renderer.getStats().drawCalls);
+        renderer.cachedText(1u, lineProps(1u), "Snake: {} segments  Head: ({}, {}) Dir: {}",
+            length,
+            static_cast<int32_t>(head.position.x),
+            static_cast<int32_t>(head.position.y),
+            static_cast<int32_t>(head.direction));
+        renderer.cachedText(2u, lineProps(2u), "Fruits: {}  Rocks: {}",
+            board.getFruits().size(), board.getRocks().size());
+        renderer.cachedText(3u, lineProps(3u), "Input: {:.1f} ms (avg {:.1f}, max {:.1f})  Buffered turns: {}/{}",
+            latency.getLastMs(), latency.getAverageMs(), latency.getMaxMs(),
+            board.getBufferedTurns(), board.getTurnBufferDepth());
+        renderer.cachedText(4u, lineProps(4u), "Segments {}-{} (page {}/{}, Tab for next)",
+            first, last == 0u ? 0u : last - 1u, page + 1u, std::max(page_count, 1u));
+
+        for (uint32_t i = first; i < last; i++) {
+            const auto& entity = snake.getEntity(i);
+            const uint32_t line = SUMMARY_LINES + (i - first);
+
+            renderer.cachedText(line, lineProps(line), "#{} Pos: ({}, {}) Dir: {}",
+                i,
+                static_cast<int32_t>(entity.position.x),
+                static_cast<int32_t>(entity.position.y),
+                static_cast<int32_t>(entity.direction));
+        }
+    }
+private:
+    static constexpr uint32_t SUMMARY_LINES = 5u;
+
+    static constexpr uint32_t GRAPH_FRAMES = 120u;
+    static constexpr float GRAPH_HEIGHT = 60.f;
+    static constexpr float GRAPH_MAX_MS = 33.3f;
+
+    /**
+     * @brief Frame times of the last GRAPH_FRAMES frames in the bottom left corner,
+     * with a reference line at 60 FPS. A single draw call.
+     */
+    auto renderFrameGraph(Renderer& renderer) -> void {
+        const float bottom = static_cast<float>(renderer.getWindowSize().y) - 5.f;
+        const auto yFor = [&](float ms) {
+            return bottom - std::min(ms / GRAPH_MAX_MS, 1.f) * GRAPH_HEIGHT;
+        };
+
+        m_graph.clear();
+
+        const sf::Color reference(94, 232, 169, 120);
+        m_graph.append({{5.f, yFor(1000.f / 60.f)}, reference, {}});
+        m_graph.append({{5.f + GRAPH_FRAMES * 2.f, yFor(1000.f / 60.f)}, reference, {}});
+
+        for (uint32_t i = 0u; i + 1u < GRAPH_FRAMES; i++) {
+            const float x = 5.f + static_cast<float>(i) * 2.f;
+            const float ms = m_frame_ms[(m_frame_cursor + i) % GRAPH_FRAMES];
+            const float next_ms = m_frame_ms[(m_frame_cursor + i + 1u) % GRAPH_FRAMES];
+
+            m_graph.append({{x, yFor(ms)}, sf::Color::White, {}});
+            m_graph.append({{x + 2.f, yFor(next_ms)}, sf::Color::White, {}});
+        }
+
+        renderer.drawDrawable(m_graph);
+    }
+
+    std::array<float, GRAPH_FRAMES> m_frame_ms{};
+    uint32_t m_frame_cursor{0u};
+    sf::VertexArray m_graph{sf::PrimitiveType::Lines};
+
+    // One text slot per line, so a line is only re-laid out when its own content changes
+    static auto lineProps(uint32_t line) -> Renderer::CachedTextProps {
+        return {.position = {5.f, 5.f + static_cast<float>(line) * 16.f}};
+    }
+
+    uint32_t m_page{0u};
+}; // class DebugOverlay
+
+} // namespace snek
@@ -1,17 +1,17 @@
 /**
  * @file Entity.hpp
  * 
- * @brief Entity struct representing a game object, renderable with a sprite.
+ * @brief Entity struct representing a game object, renderable with a sprite of the texture atlas.
  * 
  * @authors Jacek Zub
  */
 #pragma once
 
-#include <SFML/Graphics/Texture.hpp>
+#include <SFML/System/Vector2.hpp>
 
-#include <memory>
+#include <cstdint>
 
-#include "snek/constants.hpp"
+#include "snek/Assets.hpp"
 
 namespace snek {
 
@@ -22,24 +22,13 @@ enum class Direction : int32_t {
     Left = 3
 };
 
-auto getTextureRect(uint32_t tileIndex) -> sf::IntRect {
-    const auto x = static_cast<int32_t>(tileIndex) * snek::TEXTURE_TILE_SIZE;
-    const auto y = 0;
-
-    const auto w = snek::TEXTURE_TILE_SIZE;
-    const auto h = snek::TEXTURE_TILE_SIZE;
-
-    return sf::IntRect{{x, y}, {w, h}};
-}
-
 struct Entity {
     sf::Vector2f position;
+    sf::Vector2f previousPosition; // position at the previous tick, used for interpolated rendering
     sf::Vector2f size;
     Direction direction;
-    uint32_t textureIndex{0u};
+    SpriteId sprite{SpriteId::SnakeHead};
     float rotationOffsetDegrees{0.f};
-
-    const sf::Texture* texture;
 };
 
 } // namespace snek
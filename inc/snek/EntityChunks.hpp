@@ -0,0 +1,202 @@
+/**
+ * @file EntityChunks.hpp
+ *
+ * @brief Static entities bucketed into square chunks of the board, so an area can be visited
+ * without touching the rest of the world.
+ *
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "snek/constants.hpp"
+#include "snek/Entity.hpp"
+#include "snek/StateStream.hpp"
+
+namespace snek {
+
+/**
+ * @brief Entities that don't move (rocks, fruits), keyed by the chunk their center lies in.
+ *
+ * Iteration order is deterministic: chunks in the order they first got an entity, then
+ * entities in insertion order, so digests over it are stable.
+ */
+class EntityChunks {
+public:
+    static constexpr float CHUNK_PIXELS = ENTITY_CHUNK_TILES * TILE_SIZE;
+
+    EntityChunks() = default;
+
+    EntityChunks(uint32_t widthTiles, uint32_t heightTiles)
+        : m_chunks_x((widthTiles + ENTITY_CHUNK_TILES - 1u) / ENTITY_CHUNK_TILES)
+        , m_chunks_y((heightTiles + ENTITY_CHUNK_TILES - 1u) / ENTITY_CHUNK_TILES)
+        , m_chunks(static_cast<size_t>(m_chunks_x) * m_chunks_y)
+    {}
+
+    auto insert(const Entity& entity) -> void {
+        const uint32_t index = chunkAt(entity.position);
+        auto& chunk = m_chunks[index];
+
+        if (!chunk.listed) {
+            chunk.listed = true;
+            m_listed.push_back(index);
+        }
+
+        chunk.entities.push_back(entity);
+        m_size++;
+    }
+
+    /**
+     * @brief Removes the entity centered exactly at the position.
+     *
+     * @return false when there's none.
+     */
+    auto erase(sf::Vector2f position) -> bool {
+        auto& entities = m_chunks[chunkAt(position)].entities;
+
+        const auto it = std::ranges::find(entities, position, &Entity::position);
+        if (it == entities.end()) {
+            return false;
+        }
+
+        entities.erase(it);
+        m_size--;
+
+        return true;
+    }
+
+    auto size() const -> size_t {
+        return m_size;
+    }
+
+    /**
+     * @brief Calls fn(entity) for every entity.
+     */
+    template<typename Fn>
+    auto forEach(Fn&& fn) const -> void {
+        for (const auto index : m_listed) {
+            for (const auto& entity : m_chunks[index].entities) {
+                fn(entity);
+            }
+        }
+    }
+
+    /**
+     * @brief Calls fn(entity) for every entity in the chunks the area touches.
+     *
+     * Culls per chunk, some entities just outside the area are visited too. The area is
+     * grown by a tile first, so entities centered outside but reaching into it are included.
+     *
+     * @return Number of chunks visited.
+     */
+    template<typename Fn>
+    auto forEachIn(const sf::FloatRect& area, Fn&& fn) const -> uint32_t {
+        if (m_chunks.empty()) {
+            return 0u;
+        }
+
+        const auto first = chunkCoords(area.position - sf::Vector2f{TILE_SIZE, TILE_SIZE});
+        const auto last = chunkCoords(area.position + area.size + sf::Vector2f{TILE_SIZE, TILE_SIZE});
+
+        for (uint32_t y = first.y; y <= last.y; y++) {
+            for (uint32_t x = first.x; x <= last.x; x++) {
+                for (const auto& entity : m_chunks[y * m_chunks_x + x].entities) {
+                    fn(entity);
+                }
+            }
+        }
+
+        return (last.x - first.x + 1u) * (last.y - first.y + 1u);
+    }
+
+    /**
+     * @brief Writes the listed chunks with their entities, so a restore iterates in the same order.
+     */
+    auto saveState(StateWriter& writer) const -> void {
+        writer.put(m_chunks_x);
+        writer.put(m_chunks_y);
+        writer.putArray<uint32_t>(m_listed);
+
+        for (const auto index : m_listed) {
+            writer.putArray<Entity>(m_chunks[index].entities);
+        }
+    }
+
+    /**
+     * @brief Reads saveState() of chunks laid out like these, reusing the chunks' storage.
+     *
+     * @return false when the layout differs or the state is inconsistent, nothing is
+     *         left listed then.
+     */
+    auto restoreState(StateReader& reader) -> bool {
+        for (const auto index : m_listed) {
+            m_chunks[index].entities.clear();
+            m_chunks[index].listed = false;
+        }
+        m_size = 0u;
+
+        uint32_t chunks_x = 0u;
+        uint32_t chunks_y = 0u;
+        reader.get(chunks_x);
+        reader.get(chunks_y);
+
+        if (!reader.getArray(m_listed) || chunks_x != m_chunks_x || chunks_y != m_chunks_y) {
+            m_listed.clear();
+
+            return false;
+        }
+
+        for (size_t i = 0u; i < m_listed.size(); i++) {
+            const auto index = m_listed[i];
+
+            if (index >= m_chunks.size() || m_chunks[index].listed || !reader.getArray(m_chunks[index].entities)) {
+                m_listed.resize(i); // only these were marked, the rest may not even be chunks
+
+                return false;
+            }
+
+            m_chunks[index].listed = true;
+            m_size += m_chunks[index].entities.size();
+        }
+
+        return true;
+    }
+private:
+    struct Chunk {
+        std::vector<Entity> entities;
+        bool listed{false}; // in m_listed, stays so when the chunk empties
+    };
+
+    auto chunkCoords(sf::Vector2f position) const -> sf::Vector2u {
+        const auto axis = [](float pixels, uint32_t count) -> uint32_t {
+            if (pixels <= 0.f) {
+                return 0u;
+            }
+
+            return std::min(static_cast<uint32_t>(pixels / CHUNK_PIXELS), count - 1u);
+        };
+
+        return {axis(position.x, m_chunks_x), axis(position.y, m_chunks_y)};
+    }
+
+    auto chunkAt(sf::Vector2f position) const -> uint32_t {
+        const auto coords = chunkCoords(position);
+
+        return coords.y * m_chunks_x + coords.x;
+    }
+
+    uint32_t m_chunks_x{0u};
+    uint32_t m_chunks_y{0u};
+
+    std::vector<Chunk> m_chunks;
+    std::vector<uint32_t> m_listed; // chunks that ever held an entity, in that order
+    size_t m_size{0u};
+}; // class EntityChunks
+
+} // namespace snek
@@ -0,0 +1,75 @@
+/**
+ * @file FixedStepClock.hpp
+ * 
+ * @brief Fixed-step accumulator clock decoupling the simulation tick rate from the framerate.
+ * 
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+
+#include "snek/constants.hpp"
+
+namespace snek {
+
+class FixedStepClock {
+public:
+    explicit FixedStepClock(
+        uint32_t tick_rate = SIMULATION_TICK_RATE,
+        uint32_t max_ticks_per_frame = SIMULATION_MAX_TICKS_PER_FRAME
+    )
+        : m_max_ticks_per_frame(max_ticks_per_frame)
+    {
+        setTickRate(tick_rate);
+    }
+
+    /**
+     * @brief Feeds real elapsed time into the accumulator.
+     *
+     * @param elapsed_seconds Time since the previous call.
+     * @return Number of fixed ticks the simulation should run now.
+     *
+     * When more than max_ticks_per_frame ticks are due (debugger, window drag, ...)
+     * the excess time is dropped instead of spiralling into ever longer frames.
+     */
+    auto advance(float elapsed_seconds) -> uint32_t {
+        m_accumulator += std::max(elapsed_seconds, 0.f);
+
+        uint32_t ticks = 0u;
+        while (m_accumulator >= m_tick_duration && ticks < m_max_ticks_per_frame) {
+            m_accumulator -= m_tick_duration;
+            ticks++;
+        }
+
+        if (ticks == m_max_ticks_per_frame) {
+            m_accumulator = std::min(m_accumulator, m_tick_duration);
+        }
+
+        return ticks;
+    }
+
+    /**
+     * @brief How far, in [0, 1], the present moment lies between the last two ticks.
+     */
+    auto getAlpha() const -> float {
+        return std::clamp(m_accumulator / m_tick_duration, 0.f, 1.f);
+    }
+
+    auto getTickDuration() const -> float {
+        return m_tick_duration;
+    }
+
+    auto setTickRate(uint32_t tick_rate) -> void {
+        m_tick_duration = 1.f / static_cast<float>(std::max(tick_rate, 1u));
+        m_accumulator = 0.f;
+    }
+private:
+    float m_tick_duration{1.f / SIMULATION_TICK_RATE};
+    float m_accumulator{0.f};
+
+    uint32_t m_max_ticks_per_frame;
+}; // class FixedStepClock
+
+} // namespace snek
@@ -10,19 +10,18 @@
 #include <SFML/Window/Window.hpp>
 
 #include "snek/constants.hpp"
+#include "snek/InputAction.hpp"
+#include "snek/InputQueue.hpp"
 
 namespace snek {
 
-enum class InputAction {
-    Forward,
-    Backward,
-    TurnLeft,
-    TurnRight,
-    Exit,
-    None
-};
-
-auto poll_events(sf::Window& window) -> InputAction {
+/**
+ * @brief Drains every pending window event, queueing an action for each recognised key press.
+ *
+ * SFML events carry no timestamp, each action is stamped when it's taken off the
+ * window's queue. The game polls once a frame, so that's at most a frame after the press.
+ */
+inline auto poll_events(sf::Window& window, InputQueue& queue) -> void {
     using Closed = sf::Event::Closed;
     using KeyPressed = sf::Event::KeyPressed;
     using sf::Keyboard::Key;
@@ -30,8 +29,7 @@ auto poll_events(sf::Window& window) -> InputAction {
     while (const auto event = window.pollEvent()) {
         if (event->is<Closed>()) {
             window.close();
-
-            return InputAction::Exit;
+            queue.push(InputAction::Exit);
         }
         else if (event->is<KeyPressed>()) {
             const auto& key_code = event->getIf<KeyPressed>()->code;
@@ -39,26 +37,35 @@ auto poll_events(sf::Window& window) -> InputAction {
             switch (key_code) {
                 case Key::W:
                 case Key::Up:
-                    return InputAction::Forward;
+                    queue.push(InputAction::Forward);
+                    break;
                 case Key::S:
                 case Key::Down:
-                    return InputAction::Backward;
+                    queue.push(InputAction::Backward);
+                    break;
                 case Key::A:
                 case Key::Left:
-                    return InputAction::TurnLeft;
+                    queue.push(InputAction::TurnLeft);
+                    break;
                 case Key::D:
                 case Key::Right:
-                    return InputAction::TurnRight;
+                    queue.push(InputAction::TurnRight);
+                    break;
+                case Key::Tab:
+                    queue.push(InputAction::NextDebugPage);
+                    break;
+                case Key::F2:
+                    queue.push(InputAction::DumpTrace);
+                    break;
                 case Key::Escape:
                     window.close();
-                    return InputAction::Exit;
+                    queue.push(InputAction::Exit);
+                    break;
                 default:
                     break;
             }
         }
     }
-
-    return InputAction::None;
 }
 
 } // namespace snek
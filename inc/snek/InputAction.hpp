@@ -0,0 +1,23 @@
+/**
+ * @file InputAction.hpp
+ * 
+ * @brief Abstract input actions consumed by the simulation and the layers.
+ * 
+ * @authors Jacek Zub
+ */
+#pragma once
+
+namespace snek {
+
+enum class InputAction {
+    Forward,
+    Backward,
+    TurnLeft,
+    TurnRight,
+    Exit,
+    NextDebugPage,
+    DumpTrace,
+    None
+};
+
+} // namespace snek
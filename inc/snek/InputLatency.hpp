@@ -0,0 +1,81 @@
+/**
+ * @file InputLatency.hpp
+ *
+ * @brief Measures the time from a turn key press to the tick the snake actually turns on.
+ *
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+#include "snek/Board.hpp"
+#include "snek/InputQueue.hpp"
+
+namespace snek {
+
+/**
+ * @brief Pairs turns fed to a Board with the ticks that take them.
+ *
+ * A turn waits in the queue until the next tick, then maybe in the board's turn buffer
+ * until the snake can turn, both count. Dropped turns are left out.
+ */
+class InputLatency {
+public:
+    /**
+     * @brief Runs tick(), which feeds input.action to the board, and times the turns it takes.
+     */
+    template<typename Tick>
+    auto measure(const Board& board, const TimedInput& input, Tick&& tick) -> void {
+        const auto dropped = board.getTurnsDropped();
+        const auto taken = board.getTurnsTaken();
+
+        tick();
+
+        const bool is_turn = input.action == InputAction::TurnLeft || input.action == InputAction::TurnRight;
+
+        // Only the turn just fed can be dropped, the buffer never gives up older ones
+        if (is_turn && board.getTurnsDropped() == dropped) {
+            m_waiting.push(input.action, input.time);
+        }
+
+        const auto now = InputClock::now();
+        for (auto i = taken; i < board.getTurnsTaken() && !m_waiting.empty(); i++) {
+            record(now - m_waiting.pop()->time);
+        }
+    }
+
+    auto getSampleCount() const -> uint64_t {
+        return m_samples;
+    }
+
+    auto getLastMs() const -> double {
+        return m_last_ms;
+    }
+
+    auto getAverageMs() const -> double {
+        return m_samples == 0u ? 0.0 : m_total_ms / static_cast<double>(m_samples);
+    }
+
+    auto getMaxMs() const -> double {
+        return m_max_ms;
+    }
+private:
+    auto record(InputClock::duration latency) -> void {
+        m_last_ms = std::chrono::duration<double, std::milli>(latency).count();
+        m_total_ms += m_last_ms;
+        m_max_ms = std::max(m_max_ms, m_last_ms);
+        m_samples++;
+    }
+
+    InputQueue m_waiting; // turns fed to the board, not taken yet
+
+    uint64_t m_samples{0u};
+    double m_last_ms{0.0};
+    double m_total_ms{0.0};
+    double m_max_ms{0.0};
+}; // class InputLatency
+
+} // namespace snek
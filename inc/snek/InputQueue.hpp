@@ -0,0 +1,93 @@
+/**
+ * @file InputQueue.hpp
+ *
+ * @brief Bounded ring buffer of timestamped input actions, filled every frame and drained per tick.
+ *
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+#include "snek/constants.hpp"
+#include "snek/InputAction.hpp"
+
+namespace snek {
+
+using InputClock = std::chrono::steady_clock;
+
+struct TimedInput {
+    InputAction action{InputAction::None};
+    InputClock::time_point time; // when the event was taken off the window's queue
+};
+
+/**
+ * @brief FIFO of the input events not consumed by a tick yet.
+ *
+ * Never allocates. When full, new events are dropped (and counted) rather than
+ * overwriting older ones, the order of what was pressed is kept either way.
+ */
+class InputQueue {
+public:
+    static constexpr uint32_t CAPACITY = INPUT_QUEUE_CAPACITY;
+
+    /**
+     * @return false when the queue is full and the action was dropped.
+     */
+    auto push(InputAction action, InputClock::time_point time = InputClock::now()) -> bool {
+        if (m_size == CAPACITY) {
+            m_dropped++;
+
+            return false;
+        }
+
+        m_entries[(m_head + m_size) % CAPACITY] = {action, time};
+        m_size++;
+
+        return true;
+    }
+
+    auto pop() -> std::optional<TimedInput> {
+        if (m_size == 0u) {
+            return std::nullopt;
+        }
+
+        const auto entry = m_entries[m_head];
+        m_head = (m_head + 1u) % CAPACITY;
+        m_size--;
+
+        return entry;
+    }
+
+    auto front() const -> const TimedInput& {
+        return m_entries[m_head];
+    }
+
+    auto size() const -> uint32_t {
+        return m_size;
+    }
+
+    auto empty() const -> bool {
+        return m_size == 0u;
+    }
+
+    auto clear() -> void {
+        m_head = 0u;
+        m_size = 0u;
+    }
+
+    auto getDroppedCount() const -> uint64_t {
+        return m_dropped;
+    }
+private:
+    std::array<TimedInput, CAPACITY> m_entries{};
+    uint32_t m_head{0u};
+    uint32_t m_size{0u};
+
+    uint64_t m_dropped{0u};
+}; // class InputQueue
+
+} // namespace snek
@@ -7,7 +7,6 @@
  */
 #pragma once
 
-#include <SFML/Graphics/RectangleShape.hpp>
 #include <SFML/Graphics/Text.hpp>
 #include <SFML/Graphics/VertexArray.hpp>
 
@@ -15,6 +14,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <algorithm>
 #include <ranges>
@@ -30,21 +30,24 @@ public:
     auto update(const InputAction action) -> void override {
         switch (action) {
             case InputAction::Forward:
-                SoundSystem::Play(RESPATH_OPTION_WAV);
+                SoundSystem::Play(SoundId::MenuOption);
                 if (m_selectedIndex > 0) {
                     m_selectedIndex--;
+                    m_dirty = true;
                 }
                 break;
             case InputAction::Backward:
-                SoundSystem::Play(RESPATH_OPTION_WAV);
+                SoundSystem::Play(SoundId::MenuOption);
                 if (m_selectedIndex + 1 < m_items.size()) {
                     m_selectedIndex++;
+                    m_dirty = true;
                 }
                 break;
             case InputAction::TurnRight:
-                SoundSystem::Play(RESPATH_CONFIRM_WAV);
+                SoundSystem::Play(SoundId::MenuConfirm);
                 if (m_selectedIndex < m_items.size()) {
                     m_items[m_selectedIndex]->select();
+                    m_dirty = true; // toggles change their label
                 }
                 break;
             default:
@@ -52,73 +55,24 @@ public:
         }
     }
 
+    /**
+     * @brief Draws the cached geometry, rebuilding it only when marked dirty or the window size changed.
+     *
+     * All shapes (gradient, panel, highlights and their outlines) live in one vertex array,
+     * so an idle menu costs one draw call plus one per item label.
+     */
     auto render(Renderer& renderer) const -> void override {
         renderer.resetView();
 
         const auto windowSize = renderer.getWindowSize();
-        const sf::Vector2f winSizef{
-            static_cast<float>(windowSize.x),
-            static_cast<float>(windowSize.y)
-        };
-
-        sf::VertexArray background(sf::PrimitiveType::TriangleStrip, 4);
-        const sf::Color topColor(6, 18, 28);
-        const sf::Color bottomColor(20, 54, 30);
-
-        background[0].position = {0.f, 0.f};               background[0].color = topColor;
-        background[1].position = {winSizef.x, 0.f};        background[1].color = topColor;
-        background[2].position = {winSizef.x, winSizef.y}; background[2].color = bottomColor;
-        background[3].position = {0.f, winSizef.y};        background[3].color = bottomColor;
-
-        renderer.drawDrawable(background);
-
-        const uint32_t characterSize = 44u;
-        const float spacing = static_cast<float>(characterSize) + 18.f;
-        const float totalHeight = spacing * static_cast<float>(m_items.size());
-        const float startY = (winSizef.y - totalHeight) / 2.f + static_cast<float>(characterSize) / 2.f;
-
-        const float panelWidth = std::min(winSizef.x - 80.f, 520.f);
-        const float panelHeight = totalHeight + 80.f;
-        sf::RectangleShape panel({panelWidth, panelHeight});
-        panel.setOrigin({panelWidth / 2.f, panelHeight / 2.f});
-        panel.setPosition({winSizef.x / 2.f, winSizef.y / 2.f});
-        panel.setFillColor(sf::Color(8, 18, 10, 190));
-        panel.setOutlineThickness(3.f);
-        panel.setOutlineColor(sf::Color(94, 232, 169, 180));
-        renderer.drawDrawable(panel);
-
-        auto& font = renderer.getFont();
-        for (size_t i = 0; i < m_items.size(); i++) {
-            const auto& item = m_items[i];
-            const bool selected = i == m_selectedIndex;
-            const float y = startY + static_cast<float>(i) * spacing;
-
-            sf::Text text(font, item->getText(), characterSize);
-            text.setStyle(sf::Text::Bold);
-            text.setLetterSpacing(1.08f);
-
-            const auto bounds = text.getLocalBounds();
-            const float baseWidth = panelWidth * 0.7f;
-            const float highlightWidth = std::max(baseWidth, bounds.size.x + 60.f);
-            const float highlightHeight = static_cast<float>(characterSize) + 22.f;
-
-            text.setOrigin({
-                bounds.position.x + bounds.size.x / 2.f,
-                bounds.position.y + bounds.size.y / 2.f});
-            text.setPosition({winSizef.x / 2.f, y});
-            text.setFillColor(selected ? sf::Color(94, 232, 169) : sf::Color(230, 230, 230));
-            text.setOutlineThickness(selected ? 2.f : 1.f);
-            text.setOutlineColor(sf::Color(0, 0, 0, 200));
+        if (m_dirty || windowSize != m_layoutWindowSize) {
+            layout(renderer.getFont(), windowSize);
+        }
 
-            sf::RectangleShape highlight({highlightWidth, highlightHeight});
-            highlight.setOrigin({highlightWidth / 2.f, highlightHeight / 2.f});
-            highlight.setPosition({winSizef.x / 2.f, y});
-            highlight.setFillColor(selected ? sf::Color(20, 60, 36, 220) : sf::Color(0, 0, 0, 120));
-            highlight.setOutlineThickness(selected ? 2.5f : 1.5f);
-            highlight.setOutlineColor(selected ? sf::Color(94, 232, 169, 200) : sf::Color(255, 255, 255, 40));
+        renderer.drawDrawable(m_shapes);
 
-            renderer.drawDrawable(highlight);
-            renderer.drawDrawable(text);
+        for (const auto& label : m_labels) {
+            renderer.drawDrawable(label);
         }
     }
 
@@ -126,6 +80,7 @@ public:
         m_items.push_back(
             std::make_unique<Button>(text, onSelect)
         );
+        m_dirty = true;
     }
 
     auto addToggle(
@@ -137,13 +92,14 @@ public:
         m_items.push_back(
             std::make_unique<Toggle>(text, options, onSelect, defaultIndex)
         );
+        m_dirty = true;
     }
 private:
     struct IItem {
         virtual ~IItem() = default;
     
         virtual auto select() -> void = 0;
-        virtual auto getText() const -> std::string = 0;
+        virtual auto getText() const -> std::string_view = 0;
     };
 
     struct Button final : IItem {
@@ -159,7 +115,7 @@ private:
             m_onSelect();
         }
 
-        auto getText() const -> std::string override {
+        auto getText() const -> std::string_view override {
             return m_text;
         }
 
@@ -178,25 +134,134 @@ private:
             , options(options)
             , onSelect(onSelect)
             , selectedIndex(defaultIndex)
-        {}
+        {
+            updateLabel();
+        }
 
         auto select() -> void override {
             selectedIndex = (selectedIndex + 1) % options.size();
+            updateLabel();
             onSelect(options[selectedIndex]);
         }
 
-        auto getText() const -> std::string override {
-            return text + ": " + options[selectedIndex];
+        auto getText() const -> std::string_view override {
+            return label;
+        }
+
+        // Rebuilt in place on selection only, reuses the string's capacity
+        auto updateLabel() -> void {
+            label.assign(text);
+            label.append(": ");
+            label.append(options[selectedIndex]);
         }
 
         std::string text;
         std::vector<std::string> options;
         std::function<void(const std::string&)> onSelect;
         size_t selectedIndex;
+        std::string label;
     };
 
+    static auto appendRect(sf::VertexArray& vertices, sf::FloatRect rect, sf::Color top, sf::Color bottom) -> void {
+        const auto [x, y] = rect.position;
+        const auto [w, h] = rect.size;
+
+        vertices.append({{x,     y},     top,    {}});
+        vertices.append({{x + w, y},     top,    {}});
+        vertices.append({{x + w, y + h}, bottom, {}});
+        vertices.append({{x,     y},     top,    {}});
+        vertices.append({{x + w, y + h}, bottom, {}});
+        vertices.append({{x,     y + h}, bottom, {}});
+    }
+
+    static auto appendRect(sf::VertexArray& vertices, sf::FloatRect rect, sf::Color color) -> void {
+        appendRect(vertices, rect, color, color);
+    }
+
+    // Same placement as an sf::RectangleShape outline, drawn outside the rectangle
+    static auto appendOutline(sf::VertexArray& vertices, sf::FloatRect rect, float thickness, sf::Color color) -> void {
+        const auto [x, y] = rect.position;
+        const auto [w, h] = rect.size;
+        const float t = thickness;
+
+        appendRect(vertices, {{x - t, y - t}, {w + 2.f * t, t}}, color); // top
+        appendRect(vertices, {{x - t, y + h}, {w + 2.f * t, t}}, color); // bottom
+        appendRect(vertices, {{x - t, y},     {t, h}},           color); // left
+        appendRect(vertices, {{x + w, y},     {t, h}},           color); // right
+    }
+
+    static auto centeredRect(sf::Vector2f center, sf::Vector2f size) -> sf::FloatRect {
+        return {center - size / 2.f, size};
+    }
+
+    /**
+     * @brief Rebuilds the shape vertices and item labels for the current state and window size.
+     */
+    auto layout(const sf::Font& font, sf::Vector2u windowSize) const -> void {
+        const sf::Vector2f winSizef{
+            static_cast<float>(windowSize.x),
+            static_cast<float>(windowSize.y)
+        };
+
+        m_shapes.clear();
+
+        const sf::Color topColor(6, 18, 28);
+        const sf::Color bottomColor(20, 54, 30);
+        appendRect(m_shapes, {{0.f, 0.f}, winSizef}, topColor, bottomColor);
+
+        const uint32_t characterSize = 44u;
+        const float spacing = static_cast<float>(characterSize) + 18.f;
+        const float totalHeight = spacing * static_cast<float>(m_items.size());
+        const float startY = (winSizef.y - totalHeight) / 2.f + static_cast<float>(characterSize) / 2.f;
+
+        const float panelWidth = std::min(winSizef.x - 80.f, 520.f);
+        const float panelHeight = totalHeight + 80.f;
+        const auto panel = centeredRect(winSizef / 2.f, {panelWidth, panelHeight});
+        appendRect(m_shapes, panel, sf::Color(8, 18, 10, 190));
+        appendOutline(m_shapes, panel, 3.f, sf::Color(94, 232, 169, 180));
+
+        m_labels.clear();
+        for (size_t i = 0; i < m_items.size(); i++) {
+            const auto& item = m_items[i];
+            const bool selected = i == m_selectedIndex;
+            const float y = startY + static_cast<float>(i) * spacing;
+
+            auto& text = m_labels.emplace_back(font, sf::String(std::string(item->getText())), characterSize);
+            text.setStyle(sf::Text::Bold);
+            text.setLetterSpacing(1.08f);
+
+            const auto bounds = text.getLocalBounds();
+            const float baseWidth = panelWidth * 0.7f;
+            const float highlightWidth = std::max(baseWidth, bounds.size.x + 60.f);
+            const float highlightHeight = static_cast<float>(characterSize) + 22.f;
+
+            text.setOrigin({
+                bounds.position.x + bounds.size.x / 2.f,
+                bounds.position.y + bounds.size.y / 2.f});
+            text.setPosition({winSizef.x / 2.f, y});
+            text.setFillColor(selected ? sf::Color(94, 232, 169) : sf::Color(230, 230, 230));
+            text.setOutlineThickness(selected ? 2.f : 1.f);
+            text.setOutlineColor(sf::Color(0, 0, 0, 200));
+
+            const auto highlight = centeredRect({winSizef.x / 2.f, y}, {highlightWidth, highlightHeight});
+            appendRect(m_shapes, highlight, selected ? sf::Color(20, 60, 36, 220) : sf::Color(0, 0, 0, 120));
+            appendOutline(m_shapes, highlight,
+                selected ? 2.5f : 1.5f,
+                selected ? sf::Color(94, 232, 169, 200) : sf::Color(255, 255, 255, 40));
+        }
+
+        m_layoutWindowSize = windowSize;
+        m_dirty = false;
+    }
+
     std::vector<std::unique_ptr<IItem>> m_items;
     size_t m_selectedIndex{0u};
+
+    // Retained geometry, rebuilt by layout() when dirty
+    mutable sf::VertexArray m_shapes{sf::PrimitiveType::Triangles};
+    mutable std::vector<sf::Text> m_labels;
+    mutable sf::Vector2u m_layoutWindowSize{0u, 0u};
+    mutable bool m_dirty{true};
 }; // class Menu
 
 inline auto createMainMenu(
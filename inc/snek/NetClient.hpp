@@ -0,0 +1,367 @@
+/**
+ * @file NetClient.hpp
+ *
+ * @brief Client side of snek_server: sends inputs, decodes snapshots and predicts its own snake.
+ *
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <SFML/Network/IpAddress.hpp>
+#include <SFML/Network/UdpSocket.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <print>
+#include <span>
+#include <vector>
+
+#include "snek/BitStream.hpp"
+#include "snek/constants.hpp"
+#include "snek/InputAction.hpp"
+#include "snek/NetProtocol.hpp"
+#include "snek/NetState.hpp"
+#include "snek/Profiler.hpp"
+#include "snek/Snake.hpp"
+
+namespace snek {
+
+/**
+ * @brief Speed of a snake of the given length, snakes speed up by the same amount per fruit.
+ */
+inline auto snakeSpeedOf(size_t length) -> float {
+    const auto grown = length > SNAKE_INITIAL_LENGTH ? length - SNAKE_INITIAL_LENGTH : 0u;
+
+    return SNAKE_INITIAL_SPEED + static_cast<float>(grown) * SNAKE_SPEED_INCREMENT;
+}
+
+/**
+ * @brief Where a snake will be once the server took the pending inputs, one per tick.
+ *
+ * The head is advanced from the snapshot and turns when the input says so: at once in
+ * free mode, at the next cell center in grid mode. The body is then laid out a tile apart
+ * along the head's predicted path followed by the snapshot's segments, which is where the
+ * segments travel. Whether a turn is allowed yet (a tile since the last one) isn't known
+ * from a snapshot, turns are assumed allowed; the next snapshot corrects a wrong guess.
+ */
+inline auto predictSnake(
+    std::span<const NetSegment> snake,
+    std::span<const InputAction> pending,
+    Snake::Movement movement,
+    uint32_t tick_rate,
+    std::vector<NetSegment>& out
+) -> void {
+    out.assign(snake.begin(), snake.end());
+
+    if (snake.empty() || pending.empty()) {
+        return;
+    }
+
+    const float step = snakeSpeedOf(snake.size()) / static_cast<float>(tick_rate);
+    const auto rotate = [](Direction direction, InputAction action) {
+        return static_cast<Direction>((static_cast<int32_t>(direction) + (action == InputAction::TurnLeft ? 3 : 1)) % 4);
+    };
+    const auto offset = [](Direction direction) {
+        return sf::Vector2f(Snake::cellOffset(direction));
+    };
+
+    // Head path, newest point last
+    std::vector<sf::Vector2f> path{snake.front().getPosition()};
+    auto direction = snake.front().direction;
+    auto grid_direction = direction; // taken at the next cell center
+
+    for (const auto action : pending) {
+        const bool turn = action == InputAction::TurnLeft || action == InputAction::TurnRight;
+        auto head = path.back();
+        float remaining = step;
+
+        if (movement == Snake::Movement::Free) {
+            if (turn) {
+                direction = rotate(direction, action);
+            }
+        } else {
+            if (turn) {
+                grid_direction = rotate(grid_direction, action);
+            }
+
+            // Distance to the next cell center ahead, in (0, TILE_SIZE]
+            const bool horizontal = direction == Direction::Left || direction == Direction::Right;
+            const bool forward = direction == Direction::Right || direction == Direction::Down;
+            const float along = (horizontal ? head.x : head.y) / TILE_SIZE - 0.5f;
+            const float to_center = (forward ? std::floor(along) + 1.f - along : along - std::ceil(along) + 1.f) * TILE_SIZE;
+
+            if (grid_direction != direction && to_center <= remaining) {
+                head += offset(direction) * to_center;
+                path.push_back(head);
+
+                direction = grid_direction;
+                remaining -= to_center;
+            }
+        }
+
+        path.push_back(head + offset(direction) * remaining);
+    }
+
+    // Walk the predicted path back to the snapshot's head, then on along its body
+    std::vector<sf::Vector2f> points(path.rbegin(), path.rend());
+    for (size_t i = 1u; i < snake.size(); i++) {
+        points.push_back(snake[i].getPosition());
+    }
+
+    const auto travel_direction = [](sf::Vector2f from, sf::Vector2f to) {
+        const auto delta = to - from;
+
+        if (std::abs(delta.x) > std::abs(delta.y)) {
+            return delta.x > 0.f ? Direction::Right : Direction::Left;
+        }
+
+        return delta.y > 0.f ? Direction::Down : Direction::Up;
+    };
+
+    out[0] = NetSegment::fromPosition(points.front(), direction);
+
+    size_t piece = 0u; // from points[piece] back to points[piece + 1]
+    float piece_start = 0.f; // distance from the head to points[piece]
+
+    for (size_t i = 1u; i < out.size(); i++) {
+        const float distance = static_cast<float>(i) * TILE_SIZE;
+
+        while (piece + 1u < points.size()) {
+            const auto length = std::hypot(points[piece + 1u].x - points[piece].x, points[piece + 1u].y - points[piece].y);
+
+            if (piece_start + length >= distance && length > 0.f) {
+                const auto t = (distance - piece_start) / length;
+                const auto position = points[piece] + (points[piece + 1u] - points[piece]) * t;
+
+                out[i] = NetSegment::fromPosition(position, travel_direction(points[piece + 1u], points[piece]));
+                break;
+            }
+
+            piece_start += length;
+            piece++;
+        }
+
+        if (piece + 1u >= points.size()) {
+            out[i] = NetSegment::fromPosition(points.back(), out[i - 1u].direction); // ran out of path
+        }
+    }
+}
+
+/**
+ * @brief Joins a server, sends an input every tick and keeps the newest snapshot decoded.
+ *
+ * Call tick() at the server's tick rate. Decoded snapshots are kept as long as the server
+ * keeps them, deltas refer to one of those.
+ */
+class NetClient {
+public:
+    NetClient(const sf::IpAddress& server, uint16_t port)
+        : m_server(server)
+        , m_port(port)
+        , m_receive_buffer(sf::UdpSocket::MaxDatagramSize)
+    {
+        m_socket.setBlocking(false);
+        if (m_socket.bind(sf::Socket::AnyPort) != sf::Socket::Status::Done) {
+            std::println(stderr, "Failed to open a UDP socket");
+        }
+    }
+
+    NetClient(const NetClient&) = delete;
+    auto operator=(const NetClient&) -> NetClient& = delete;
+
+    ~NetClient() {
+        if (m_welcome) {
+            beginMessage(m_writer, NetMessage::Bye);
+            sendWriter();
+        }
+    }
+
+    /**
+     * @brief Takes what the server sent, then sends this tick's action (or a Hello while not joined).
+     */
+    auto tick(InputAction action) -> void {
+        SNEK_PROFILE_SCOPE("NetClient::tick");
+
+        receive();
+
+        if (!m_welcome) {
+            beginMessage(m_writer, NetMessage::Hello);
+            m_writer.putBits(NET_PROTOCOL_VERSION, 16u);
+            sendWriter();
+
+            return;
+        }
+
+        m_seq++;
+        m_actions[m_seq % m_actions.size()] = action;
+
+        NetInput input;
+        input.match = m_welcome->match;
+        input.ackTick = m_latest != nullptr ? std::optional{m_latest->tick} : std::nullopt;
+        input.seq = m_seq;
+        for (uint32_t seq = m_seq - std::min(m_seq, NET_INPUT_REDUNDANCY) + 1u; seq <= m_seq; seq++) {
+            input.actions.push_back(m_actions[seq % m_actions.size()]);
+        }
+
+        encodeInput(m_writer, input);
+        sendWriter();
+
+        predict();
+    }
+
+    auto getWelcome() const -> const std::optional<NetWelcome>& {
+        return m_welcome;
+    }
+
+    /**
+     * @brief Newest snapshot decoded, nullptr before the first one of the match.
+     */
+    auto getState() const -> const NetState* {
+        return m_latest;
+    }
+
+    /**
+     * @brief The client's own snake from the newest snapshot, moved on by the inputs the server hasn't taken yet.
+     */
+    auto getPredictedSnake() const -> std::span<const NetSegment> {
+        return m_predicted;
+    }
+
+    auto getBytesSent() const -> uint64_t {
+        return m_bytes_sent;
+    }
+
+    auto getBytesReceived() const -> uint64_t {
+        return m_bytes_received;
+    }
+
+    auto getSnapshotCount() const -> uint64_t {
+        return m_snapshots;
+    }
+
+    /**
+     * @brief Snapshots dropped for being malformed or referring to a baseline not kept here.
+     */
+    auto getRejectedCount() const -> uint64_t {
+        return m_rejected;
+    }
+private:
+    auto receive() -> void {
+        std::size_t received = 0u;
+        std::optional<sf::IpAddress> address;
+        uint16_t port = 0u;
+
+        while (m_socket.receive(m_receive_buffer.data(), m_receive_buffer.size(), received, address, port) == sf::Socket::Status::Done) {
+            if (address != m_server || port != m_port) {
+                continue;
+            }
+
+            m_bytes_received += received;
+
+            BitReader reader{std::span{m_receive_buffer}.first(received)};
+            const auto message = readMessage(reader);
+
+            if (message == NetMessage::Welcome) {
+                auto welcome = decodeWelcome(reader);
+
+                if (welcome && (!m_welcome || welcome->match != m_welcome->match)) {
+                    m_welcome = std::move(welcome);
+                    m_latest = nullptr;
+                    m_last_input.reset();
+                    m_predicted.clear();
+                    std::ranges::for_each(m_history, [](NetState& state) { state.tick = 0u; });
+                }
+            } else if (message == NetMessage::Snapshot && m_welcome) {
+                takeSnapshot(reader);
+            }
+        }
+    }
+
+    auto takeSnapshot(BitReader& reader) -> void {
+        const auto header = decodeSnapshotHeader(reader);
+        if (header.match != m_welcome->match) {
+            return;
+        }
+
+        auto state = decodeState(reader, [&](uint32_t tick) -> const NetState* {
+            const auto& baseline = m_history[tick % NET_SNAPSHOT_HISTORY];
+
+            return baseline.tick == tick && tick != 0u ? &baseline : nullptr;
+        });
+
+        if (!state) {
+            m_rejected++;
+
+            return;
+        }
+
+        m_snapshots++;
+
+        // Out of order datagrams may still serve as baselines, only the newest is shown
+        auto& slot = m_history[state->tick % NET_SNAPSHOT_HISTORY];
+        slot = std::move(*state);
+
+        if (m_latest == nullptr || slot.tick > m_latest->tick) {
+            m_latest = &slot;
+            m_last_input = header.lastInput;
+        }
+    }
+
+    auto predict() -> void {
+        m_predicted.clear();
+
+        if (m_latest == nullptr || m_welcome->slot >= m_latest->snakes.size()) {
+            return;
+        }
+
+        // Inputs sent but not taken by the board yet, as far as the newest snapshot knows
+        m_pending.clear();
+        if (m_last_input) {
+            const auto unapplied = std::min<uint32_t>(m_seq - *m_last_input, m_actions.size());
+
+            for (uint32_t seq = m_seq - unapplied + 1u; seq <= m_seq; seq++) {
+                m_pending.push_back(m_actions[seq % m_actions.size()]);
+            }
+        }
+
+        predictSnake(m_latest->snakes[m_welcome->slot], m_pending, m_welcome->movement, m_welcome->tickRate, m_predicted);
+    }
+
+    auto sendWriter() -> void {
+        const auto bytes = m_writer.getBytes();
+
+        if (m_socket.send(bytes.data(), bytes.size(), m_server, m_port) == sf::Socket::Status::Done) {
+            m_bytes_sent += bytes.size();
+        }
+    }
+
+    sf::IpAddress m_server;
+    uint16_t m_port;
+    sf::UdpSocket m_socket;
+    BitWriter m_writer;
+    std::vector<uint8_t> m_receive_buffer;
+
+    std::optional<NetWelcome> m_welcome;
+
+    // Decoded snapshots at tick % NET_SNAPSHOT_HISTORY, baselines of the next deltas
+    std::array<NetState, NET_SNAPSHOT_HISTORY> m_history{};
+    const NetState* m_latest{nullptr};
+    std::optional<uint32_t> m_last_input;
+
+    // Actions sent, at seq % size, kept until the board took them
+    std::array<InputAction, NET_SNAPSHOT_HISTORY> m_actions{};
+    uint32_t m_seq{0u};
+
+    std::vector<InputAction> m_pending;
+    std::vector<NetSegment> m_predicted;
+
+    uint64_t m_bytes_sent{0u};
+    uint64_t m_bytes_received{0u};
+    uint64_t m_snapshots{0u};
+    uint64_t m_rejected{0u};
+}; // class NetClient
+
+} // namespace snek
@@ -0,0 +1,211 @@
+/**
+ * @file NetProtocol.hpp
+ *
+ * @brief Datagrams exchanged between snek_server and its clients over UDP.
+ *
+ * Every datagram starts with an 8 bit NetMessage, the rest is bit-packed:
+ *   Hello     client -> server, protocol version, repeated until a Welcome comes back
+ *   Welcome   server -> client, the match: slot, board size, tick rate, movement and the
+ *             rocks, sent once per match (again while the client's inputs name another match)
+ *   Input     client -> server, every tick, the newest inputs and the newest snapshot decoded
+ *   Snapshot  server -> client, every tick, the board as a delta to the acknowledged snapshot
+ *   Bye       client -> server, frees the slot right away
+ *
+ * Nothing is resent: inputs ride along in the next packets, snapshots are superseded.
+ *
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "snek/BitStream.hpp"
+#include "snek/constants.hpp"
+#include "snek/InputAction.hpp"
+#include "snek/NetState.hpp"
+#include "snek/Snake.hpp"
+
+namespace snek {
+
+enum class NetMessage : uint8_t {
+    Hello = 1u,
+    Welcome,
+    Input,
+    Snapshot,
+    Bye
+};
+
+struct NetWelcome {
+    uint32_t match{0u}; // changes whenever the server starts a new board
+    uint32_t slot{0u};  // the snake the client steers, 0 is the board's own snake
+    uint32_t width{0u};
+    uint32_t height{0u};
+    uint32_t tickRate{SIMULATION_TICK_RATE};
+    Snake::Movement movement{Snake::Movement::Free};
+    std::vector<uint32_t> rocks; // row-major cell ids, sorted
+};
+
+struct NetInput {
+    uint32_t match{0u}; // the match the client believes it plays
+    std::optional<uint32_t> ackTick; // newest snapshot the client decoded
+    uint32_t seq{0u}; // sequence number of the newest action, one per client tick
+    std::vector<InputAction> actions; // the last NET_INPUT_REDUNDANCY at most, oldest first
+};
+
+struct NetSnapshotHeader {
+    uint32_t match{0u};
+    std::optional<uint32_t> lastInput; // seq of the client's newest input the board has taken
+};
+
+inline auto beginMessage(BitWriter& writer, NetMessage message) -> void {
+    writer.clear();
+    writer.putBits(static_cast<uint8_t>(message), 8u);
+}
+
+inline auto readMessage(BitReader& reader) -> NetMessage {
+    return static_cast<NetMessage>(reader.getBits(8u));
+}
+
+inline auto putOptional(BitWriter& writer, std::optional<uint32_t> value) -> void {
+    writer.putBool(value.has_value());
+    if (value) {
+        writer.putBits(*value, 32u);
+    }
+}
+
+inline auto getOptional(BitReader& reader) -> std::optional<uint32_t> {
+    if (!reader.getBool()) {
+        return std::nullopt;
+    }
+
+    return static_cast<uint32_t>(reader.getBits(32u));
+}
+
+/**
+ * @brief Turns take 2 bits on the wire, anything else the board ignores is sent as None.
+ */
+inline auto putAction(BitWriter& writer, InputAction action) -> void {
+    switch (action) {
+        case InputAction::TurnLeft: writer.putBits(1u, 2u); break;
+        case InputAction::TurnRight: writer.putBits(2u, 2u); break;
+        default: writer.putBits(0u, 2u); break;
+    }
+}
+
+inline auto getAction(BitReader& reader) -> InputAction {
+    switch (reader.getBits(2u)) {
+        case 1u: return InputAction::TurnLeft;
+        case 2u: return InputAction::TurnRight;
+        default: return InputAction::None;
+    }
+}
+
+inline auto encodeWelcome(BitWriter& writer, const NetWelcome& welcome) -> void {
+    beginMessage(writer, NetMessage::Welcome);
+
+    writer.putBits(welcome.match, 32u);
+    writer.putUnsigned(welcome.slot);
+    writer.putUnsigned(welcome.width);
+    writer.putUnsigned(welcome.height);
+    writer.putUnsigned(welcome.tickRate);
+    writer.putBool(welcome.movement == Snake::Movement::Grid);
+    encodeSorted(writer, welcome.rocks);
+}
+
+/**
+ * @brief Reads a Welcome past its message byte.
+ */
+inline auto decodeWelcome(BitReader& reader) -> std::optional<NetWelcome> {
+    NetWelcome welcome;
+    welcome.match = static_cast<uint32_t>(reader.getBits(32u));
+    welcome.slot = static_cast<uint32_t>(reader.getUnsigned());
+    welcome.width = static_cast<uint32_t>(reader.getUnsigned());
+    welcome.height = static_cast<uint32_t>(reader.getUnsigned());
+    welcome.tickRate = static_cast<uint32_t>(reader.getUnsigned());
+    welcome.movement = reader.getBool() ? Snake::Movement::Grid : Snake::Movement::Free;
+
+    const bool valid = !reader.failed() &&
+        welcome.width >= 1u && welcome.width <= BOARD_MAX_SIZE &&
+        welcome.height >= 1u && welcome.height <= BOARD_MAX_SIZE &&
+        welcome.tickRate >= 1u;
+    if (!valid) {
+        return std::nullopt;
+    }
+
+    auto rocks = decodeSorted(reader, welcome.width * welcome.height);
+    if (!rocks || (!rocks->empty() && rocks->back() >= welcome.width * welcome.height)) {
+        return std::nullopt;
+    }
+
+    welcome.rocks = std::move(*rocks);
+
+    return welcome;
+}
+
+inline auto encodeInput(BitWriter& writer, const NetInput& input) -> void {
+    beginMessage(writer, NetMessage::Input);
+
+    writer.putBits(input.match, 32u);
+    putOptional(writer, input.ackTick);
+    writer.putBits(input.seq, 32u);
+    writer.putUnsigned(input.actions.size());
+
+    for (const auto action : input.actions) {
+        putAction(writer, action);
+    }
+}
+
+/**
+ * @brief Reads an Input past its message byte.
+ */
+inline auto decodeInput(BitReader& reader) -> std::optional<NetInput> {
+    NetInput input;
+    input.match = static_cast<uint32_t>(reader.getBits(32u));
+    input.ackTick = getOptional(reader);
+    input.seq = static_cast<uint32_t>(reader.getBits(32u));
+
+    const auto count = reader.getUnsigned();
+    if (count > NET_INPUT_REDUNDANCY || count > input.seq) {
+        return std::nullopt;
+    }
+
+    input.actions.resize(count);
+    for (auto& action : input.actions) {
+        action = getAction(reader);
+    }
+
+    if (reader.failed()) {
+        return std::nullopt;
+    }
+
+    return input;
+}
+
+inline auto encodeSnapshot(
+    BitWriter& writer,
+    const NetSnapshotHeader& header,
+    const NetState& state,
+    const NetState* baseline
+) -> void {
+    beginMessage(writer, NetMessage::Snapshot);
+
+    writer.putBits(header.match, 32u);
+    putOptional(writer, header.lastInput);
+    encodeState(writer, state, baseline);
+}
+
+/**
+ * @brief Reads a Snapshot's header past its message byte, decodeState() reads the rest.
+ */
+inline auto decodeSnapshotHeader(BitReader& reader) -> NetSnapshotHeader {
+    NetSnapshotHeader header;
+    header.match = static_cast<uint32_t>(reader.getBits(32u));
+    header.lastInput = getOptional(reader);
+
+    return header;
+}
+
+} // namespace snek
@@ -0,0 +1,374 @@
+/**
+ * @file NetServer.hpp
+ *
+ * @brief Authoritative game server, ticks a Board and steers its snakes from client inputs over UDP.
+ *
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <SFML/Network/IpAddress.hpp>
+#include <SFML/Network/UdpSocket.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <print>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "snek/BitStream.hpp"
+#include "snek/Board.hpp"
+#include "snek/constants.hpp"
+#include "snek/Controller.hpp"
+#include "snek/InputQueue.hpp"
+#include "snek/NetProtocol.hpp"
+#include "snek/NetState.hpp"
+#include "snek/Profiler.hpp"
+
+namespace snek {
+
+/**
+ * @brief One match at a time on a board with a snake per slot, slot 0 being the board's own.
+ *
+ * A client takes the lowest free slot, free slots are steered by wander(). The match starts
+ * over on a new board when slot 0's snake dies. Every tick each client gets a snapshot
+ * encoded against the newest one it acknowledged, or a whole one when that's too old.
+ */
+class NetServer {
+public:
+    struct Config {
+        Board::Config board; // arenaSnakes is set from slots
+        uint16_t port{NET_DEFAULT_PORT};
+        uint32_t slots{8u};
+    };
+
+    explicit NetServer(const Config& config)
+        : m_config(config)
+        , m_slots(std::max(config.slots, 1u))
+        , m_base_seed(config.board.seed.value_or(std::random_device{}()))
+        , m_timeout_ticks(static_cast<uint32_t>(NET_CLIENT_TIMEOUT_SECONDS * static_cast<float>(config.board.tickRate)))
+        , m_receive_buffer(sf::UdpSocket::MaxDatagramSize)
+    {
+        m_config.board.arenaSnakes = static_cast<uint32_t>(m_slots.size() - 1u);
+
+        for (uint32_t slot = 0u; slot < m_slots.size(); slot++) {
+            m_bots.emplace_back(m_base_seed * 7919u + slot + 1u);
+        }
+
+        m_socket.setBlocking(false);
+        m_listening = m_socket.bind(config.port) == sf::Socket::Status::Done;
+        if (!m_listening) {
+            std::println(stderr, "Failed to bind UDP port {}", config.port);
+        }
+
+        startMatch();
+    }
+
+    auto isListening() const -> bool {
+        return m_listening;
+    }
+
+    auto getPort() const -> uint16_t {
+        return m_socket.getLocalPort();
+    }
+
+    /**
+     * @brief Takes the waiting datagrams, advances the board a tick and sends the snapshots.
+     */
+    auto tick() -> void {
+        SNEK_PROFILE_SCOPE("NetServer::tick");
+
+        receive();
+
+        m_tick++;
+
+        // Each client's oldest queued input, so a burst of them plays out over as many ticks
+        for (uint32_t slot = 0u; slot < m_slots.size(); slot++) {
+            auto& client = m_slots[slot];
+            const auto& snake = slot == 0u ? m_board->getSnake() : m_board->getArenaSnakes()[slot - 1u];
+
+            InputAction action = InputAction::None;
+            if (!client) {
+                action = wander(*m_board, snake, m_bots[slot]);
+            } else if (const auto input = client->inputs.pop()) {
+                action = input->action;
+                client->appliedSeq = client->receivedSeq - client->inputs.size();
+            }
+
+            if (slot == 0u) {
+                m_player_action = action;
+            } else {
+                m_arena_actions[slot - 1u] = action;
+            }
+        }
+
+        m_board->update(m_player_action, m_arena_actions);
+
+        if (m_board->getState() != Board::State::Playing) {
+            startMatch();
+        }
+
+        auto& state = m_history[m_tick % NET_SNAPSHOT_HISTORY];
+        captureState(*m_board, m_tick, state);
+
+        for (uint32_t slot = 0u; slot < m_slots.size(); slot++) {
+            auto& client = m_slots[slot];
+            if (!client) {
+                continue;
+            }
+
+            if (m_tick - client->lastHeard > m_timeout_ticks) {
+                std::println("Client {}:{} timed out, slot {} is free", client->address.toString(), client->port, slot);
+
+                m_departed_client_ticks += client->ticks;
+                client.reset();
+
+                continue;
+            }
+
+            if (client->match != m_match) {
+                m_welcome.slot = slot;
+                encodeWelcome(m_writer, m_welcome);
+            } else {
+                const NetSnapshotHeader header{m_match, client->appliedSeq};
+                encodeSnapshot(m_writer, header, state, client->ackTick ? findState(*client->ackTick) : nullptr);
+            }
+
+            send(*client);
+            client->ticks++;
+        }
+    }
+
+    /**
+     * @brief Snapshot of a recent tick of the current match, nullptr when it's no longer kept.
+     */
+    auto findState(uint32_t tick) const -> const NetState* {
+        const auto& state = m_history[tick % NET_SNAPSHOT_HISTORY];
+
+        return state.tick == tick && tick > m_match_start_tick && m_tick - tick < NET_SNAPSHOT_HISTORY ? &state : nullptr;
+    }
+
+    auto getBoard() const -> const Board& {
+        return *m_board;
+    }
+
+    auto getTick() const -> uint32_t {
+        return m_tick;
+    }
+
+    auto getMatch() const -> uint32_t {
+        return m_match;
+    }
+
+    auto getClientCount() const -> uint32_t {
+        return static_cast<uint32_t>(std::ranges::count_if(m_slots, [](const auto& client) { return client.has_value(); }));
+    }
+
+    auto getBytesSent() const -> uint64_t {
+        return m_bytes_sent;
+    }
+
+    auto getBytesReceived() const -> uint64_t {
+        return m_bytes_received;
+    }
+
+    /**
+     * @brief Ticks summed over every client connected during them, divides the bytes into per client per tick.
+     */
+    auto getClientTicks() const -> uint64_t {
+        uint64_t ticks = m_departed_client_ticks;
+        for (const auto& client : m_slots) {
+            ticks += client ? client->ticks : 0u;
+        }
+
+        return ticks;
+    }
+private:
+    struct Client {
+        sf::IpAddress address;
+        uint16_t port;
+        uint32_t match{0u}; // the one it last said it plays, 0 before its first input
+        uint32_t lastHeard{0u};
+        std::optional<uint32_t> ackTick{};
+        uint32_t receivedSeq{0u}; // newest input seq queued
+        std::optional<uint32_t> appliedSeq{};
+        InputQueue inputs{};
+        uint64_t ticks{0u};
+    };
+
+    auto startMatch() -> void {
+        m_match++;
+        m_match_start_tick = m_tick;
+
+        auto board_config = m_config.board;
+        board_config.seed = m_base_seed + m_match;
+
+        m_board.emplace(board_config);
+
+        m_arena_actions.assign(m_board->getArenaSnakes().size(), InputAction::None);
+
+        m_welcome.match = m_match;
+        m_welcome.width = m_board->getWidth();
+        m_welcome.height = m_board->getHeight();
+        m_welcome.tickRate = m_board->getTickRate();
+        m_welcome.movement = m_board->getSnake().getMovement();
+        m_welcome.rocks.clear();
+        m_board->getRocks().forEach([&](const Entity& rock) {
+            const auto x = static_cast<uint32_t>(rock.position.x / TILE_SIZE);
+            const auto y = static_cast<uint32_t>(rock.position.y / TILE_SIZE);
+
+            m_welcome.rocks.push_back(y * m_welcome.width + x);
+        });
+        std::ranges::sort(m_welcome.rocks);
+    }
+
+    auto receive() -> void {
+        std::size_t received = 0u;
+        std::optional<sf::IpAddress> address;
+        uint16_t port = 0u;
+
+        while (m_socket.receive(m_receive_buffer.data(), m_receive_buffer.size(), received, address, port) == sf::Socket::Status::Done) {
+            if (!address) {
+                continue;
+            }
+
+            m_bytes_received += received;
+
+            BitReader reader{std::span{m_receive_buffer}.first(received)};
+            const auto message = readMessage(reader);
+            auto* client = findClient(*address, port);
+
+            if (message == NetMessage::Hello) {
+                if (client == nullptr && reader.getBits(16u) == NET_PROTOCOL_VERSION) {
+                    join(*address, port);
+                }
+            } else if (message == NetMessage::Input && client != nullptr) {
+                if (const auto input = decodeInput(reader)) {
+                    takeInput(*client, *input);
+                }
+            } else if (message == NetMessage::Bye && client != nullptr) {
+                leave(*client);
+            }
+        }
+    }
+
+    auto join(const sf::IpAddress& address, uint16_t port) -> void {
+        for (uint32_t slot = 0u; slot < m_slots.size(); slot++) {
+            if (!m_slots[slot]) {
+                m_slots[slot].emplace(Client{.address = address, .port = port, .lastHeard = m_tick});
+                std::println("Client {}:{} joined in slot {}", address.toString(), port, slot);
+
+                return;
+            }
+        }
+
+        if (m_full_reported++ == 0u) {
+            std::println("Client {}:{} turned away, all {} slots are taken", address.toString(), port, m_slots.size());
+        }
+    }
+
+    auto leave(Client& client) -> void {
+        for (auto& slot : m_slots) {
+            if (slot && &*slot == &client) {
+                std::println("Client {}:{} left", client.address.toString(), client.port);
+
+                m_departed_client_ticks += client.ticks;
+                slot.reset();
+
+                return;
+            }
+        }
+    }
+
+    auto takeInput(Client& client, const NetInput& input) -> void {
+        client.lastHeard = m_tick;
+
+        if (input.match != m_match) {
+            client.match = input.match; // gets a Welcome until it catches up
+
+            return;
+        }
+
+        if (client.match != m_match) {
+            // First input of this match, what was queued or repeated belongs to the previous board
+            client.match = m_match;
+            client.ackTick.reset();
+            client.inputs.clear();
+            client.appliedSeq.reset();
+            client.receivedSeq = input.seq - 1u;
+        }
+
+        if (input.ackTick && (!client.ackTick || *input.ackTick > *client.ackTick)) {
+            client.ackTick = input.ackTick;
+        }
+
+        // Redundant copies of inputs queued before are skipped by their seq
+        const uint32_t first_seq = input.seq + 1u - static_cast<uint32_t>(input.actions.size());
+        for (uint32_t i = 0u; i < input.actions.size(); i++) {
+            if (first_seq + i > client.receivedSeq) {
+                client.inputs.push(input.actions[i]);
+                client.receivedSeq = first_seq + i;
+            }
+        }
+    }
+
+    auto findClient(const sf::IpAddress& address, uint16_t port) -> Client* {
+        for (auto& client : m_slots) {
+            if (client && client->address == address && client->port == port) {
+                return &*client;
+            }
+        }
+
+        return nullptr;
+    }
+
+    auto send(const Client& client) -> void {
+        const auto bytes = m_writer.getBytes();
+
+        if (bytes.size() > sf::UdpSocket::MaxDatagramSize) {
+            if (m_oversize_reported++ == 0u) {
+                std::println(stderr, "Snapshot of {} bytes doesn't fit a datagram, not sent", bytes.size());
+            }
+
+            return;
+        }
+
+        if (m_socket.send(bytes.data(), bytes.size(), client.address, client.port) == sf::Socket::Status::Done) {
+            m_bytes_sent += bytes.size();
+        }
+    }
+
+    Config m_config;
+    std::vector<std::optional<Client>> m_slots;
+    std::vector<std::minstd_rand> m_bots; // steer the free slots
+    uint32_t m_base_seed;
+    uint32_t m_timeout_ticks;
+
+    std::optional<Board> m_board;
+    uint32_t m_match{0u};
+    uint32_t m_match_start_tick{0u};
+    uint32_t m_tick{0u};
+    NetWelcome m_welcome;
+
+    InputAction m_player_action{InputAction::None};
+    std::vector<InputAction> m_arena_actions;
+
+    // The last ticks' states, baselines for the deltas, at tick % NET_SNAPSHOT_HISTORY
+    std::array<NetState, NET_SNAPSHOT_HISTORY> m_history{};
+
+    sf::UdpSocket m_socket;
+    bool m_listening{false};
+    BitWriter m_writer;
+    std::vector<uint8_t> m_receive_buffer;
+
+    uint64_t m_bytes_sent{0u};
+    uint64_t m_bytes_received{0u};
+    uint64_t m_departed_client_ticks{0u};
+    uint32_t m_full_reported{0u};
+    uint32_t m_oversize_reported{0u};
+}; // class NetServer
+
+} // namespace snek
@@ -0,0 +1,319 @@
+/**
+ * @file NetState.hpp
+ *
+ * @brief What a server tells its clients about a board each tick, and its bit-packed delta encoding.
+ *
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "snek/BitStream.hpp"
+#include "snek/Board.hpp"
+#include "snek/constants.hpp"
+#include "snek/Entity.hpp"
+#include "snek/Snake.hpp"
+
+namespace snek {
+
+/**
+ * @brief A snake segment as sent, in 1/NET_POSITION_SCALE pixel steps.
+ */
+struct NetSegment {
+    int32_t x{0};
+    int32_t y{0};
+    Direction direction{Direction::Up};
+
+    auto operator==(const NetSegment&) const -> bool = default;
+
+    static auto fromPosition(sf::Vector2f position, Direction direction) -> NetSegment {
+        return {
+            static_cast<int32_t>(std::lround(position.x * NET_POSITION_SCALE)),
+            static_cast<int32_t>(std::lround(position.y * NET_POSITION_SCALE)),
+            direction};
+    }
+
+    auto getPosition() const -> sf::Vector2f {
+        return {static_cast<float>(x) / NET_POSITION_SCALE, static_cast<float>(y) / NET_POSITION_SCALE};
+    }
+
+    /**
+     * @brief The segment moved the given distance along its direction.
+     */
+    auto advanced(int32_t distance) const -> NetSegment {
+        const auto offset = Snake::cellOffset(direction);
+
+        return {x + offset.x * distance, y + offset.y * distance, direction};
+    }
+};
+
+/**
+ * @brief Every snake and fruit of a board at one tick. Rocks never change, they're sent once.
+ *
+ * Snake 0 is the board's own snake, snake i is arena snake i - 1, segments head first.
+ * Fruits are row-major cell ids (y * width + x), sorted.
+ */
+struct NetState {
+    uint32_t tick{0u};
+    std::vector<std::vector<NetSegment>> snakes;
+    std::vector<uint32_t> fruits;
+
+    auto operator==(const NetState&) const -> bool = default;
+};
+
+/**
+ * @brief Fills state with the board as it is after the given tick, reuses state's storage.
+ */
+inline auto captureState(const Board& board, uint32_t tick, NetState& state) -> void {
+    const auto capture = [](const Snake& snake, std::vector<NetSegment>& out) {
+        out.clear();
+
+        for (const auto& segment : snake.getEntities()) {
+            out.push_back(NetSegment::fromPosition(segment.position, segment.direction));
+        }
+    };
+
+    const auto arena = board.getArenaSnakes();
+
+    state.tick = tick;
+    state.snakes.resize(arena.size() + 1u);
+
+    capture(board.getSnake(), state.snakes[0]);
+    for (size_t i = 0u; i < arena.size(); i++) {
+        capture(arena[i], state.snakes[i + 1u]);
+    }
+
+    state.fruits.clear();
+    board.getFruits().forEach([&](const Entity& fruit) {
+        const auto x = static_cast<uint32_t>(fruit.position.x / TILE_SIZE);
+        const auto y = static_cast<uint32_t>(fruit.position.y / TILE_SIZE);
+
+        state.fruits.push_back(y * board.getWidth() + x);
+    });
+    std::ranges::sort(state.fruits);
+}
+
+/**
+ * @brief Sorted values as gaps between neighbours, a dense set costs a few bits per value.
+ */
+inline auto encodeSorted(BitWriter& writer, std::span<const uint32_t> values) -> void {
+    writer.putUnsigned(values.size());
+
+    uint32_t previous = 0u;
+    for (const auto value : values) {
+        writer.putUnsigned(value - previous);
+        previous = value;
+    }
+}
+
+/**
+ * @return nullopt when the data is cut short or holds more than max_count values.
+ */
+inline auto decodeSorted(BitReader& reader, size_t max_count) -> std::optional<std::vector<uint32_t>> {
+    const auto count = reader.getUnsigned();
+
+    // Every value takes a bit at least, a count beyond that can only be garbage
+    if (count > max_count || count > reader.remainingBits()) {
+        return std::nullopt;
+    }
+
+    std::vector<uint32_t> values(count);
+
+    uint32_t previous = 0u;
+    for (auto& value : values) {
+        value = previous + static_cast<uint32_t>(reader.getUnsigned());
+        previous = value;
+    }
+
+    if (reader.failed()) {
+        return std::nullopt;
+    }
+
+    return values;
+}
+
+/**
+ * @brief Where segment j is expected, the decoder computes the same from what it read so far.
+ *
+ * Against a baseline every segment of a snake travels as far as its head did, along its own
+ * direction. Segments past the baseline's tail, and every segment without a baseline, are
+ * expected on the previous one.
+ */
+inline auto expectedSegment(std::span<const NetSegment> snake, const std::vector<NetSegment>* base, int32_t step, size_t j) -> NetSegment {
+    if (base != nullptr && j < base->size()) {
+        return (*base)[j].advanced(step);
+    }
+
+    return j > 0u ? snake[j - 1u] : NetSegment{};
+}
+
+/**
+ * @brief Writes state as the difference to baseline, or whole when there's no baseline.
+ *
+ * A snake's segments all move by the same distance along their directions, so against a
+ * baseline that distance is sent once per snake and each segment as its offset to where
+ * it's expected then. The offsets are zero apart from segments turning a corner and
+ * rounding, which takes 3 bits a segment. Fruits are sent as the ones removed and added.
+ */
+inline auto encodeState(BitWriter& writer, const NetState& state, const NetState* baseline) -> void {
+    writer.putBits(state.tick, 32u);
+    writer.putBool(baseline != nullptr);
+    if (baseline != nullptr) {
+        writer.putBits(baseline->tick, 32u);
+    }
+
+    writer.putUnsigned(state.snakes.size());
+
+    for (size_t i = 0u; i < state.snakes.size(); i++) {
+        const auto& snake = state.snakes[i];
+        const auto* base = baseline != nullptr && i < baseline->snakes.size() ? &baseline->snakes[i] : nullptr;
+
+        int32_t step = 0;
+        if (base != nullptr) {
+            writer.putSigned(static_cast<int64_t>(snake.size()) - static_cast<int64_t>(base->size()));
+
+            if (!snake.empty() && !base->empty()) {
+                step = std::abs(snake[0].x - (*base)[0].x) + std::abs(snake[0].y - (*base)[0].y);
+            }
+            writer.putUnsigned(static_cast<uint32_t>(step));
+        } else {
+            writer.putUnsigned(snake.size());
+        }
+
+        for (size_t j = 0u; j < snake.size(); j++) {
+            const auto& segment = snake[j];
+            const auto reference = expectedSegment(snake, base, step, j);
+
+            writer.putSigned(segment.x - reference.x);
+            writer.putSigned(segment.y - reference.y);
+            writer.putBool(segment.direction != reference.direction);
+            if (segment.direction != reference.direction) {
+                writer.putBits(static_cast<uint32_t>(segment.direction), 2u);
+            }
+        }
+    }
+
+    if (baseline == nullptr) {
+        encodeSorted(writer, state.fruits);
+
+        return;
+    }
+
+    // Removed fruits go as their indices in the baseline, added ones as cells
+    std::vector<uint32_t> removed;
+    for (uint32_t i = 0u; i < baseline->fruits.size(); i++) {
+        if (!std::ranges::binary_search(state.fruits, baseline->fruits[i])) {
+            removed.push_back(i);
+        }
+    }
+
+    std::vector<uint32_t> added;
+    std::ranges::set_difference(state.fruits, baseline->fruits, std::back_inserter(added));
+
+    encodeSorted(writer, removed);
+    encodeSorted(writer, added);
+}
+
+/**
+ * @brief Reads encodeState(), find_baseline(tick) returns the state a delta refers to or nullptr.
+ *
+ * @return nullopt when the data is malformed or the baseline isn't known (anymore).
+ */
+inline auto decodeState(
+    BitReader& reader,
+    const std::function<const NetState*(uint32_t)>& find_baseline
+) -> std::optional<NetState> {
+    NetState state;
+    state.tick = static_cast<uint32_t>(reader.getBits(32u));
+
+    const NetState* baseline = nullptr;
+    if (reader.getBool()) {
+        baseline = find_baseline(static_cast<uint32_t>(reader.getBits(32u)));
+
+        if (baseline == nullptr) {
+            return std::nullopt;
+        }
+    }
+
+    const auto snake_count = reader.getUnsigned();
+    if (snake_count > reader.remainingBits()) {
+        return std::nullopt;
+    }
+
+    state.snakes.resize(snake_count);
+
+    for (size_t i = 0u; i < state.snakes.size(); i++) {
+        auto& snake = state.snakes[i];
+        const auto* base = baseline != nullptr && i < baseline->snakes.size() ? &baseline->snakes[i] : nullptr;
+
+        const auto length = base != nullptr
+            ? static_cast<int64_t>(base->size()) + reader.getSigned()
+            : static_cast<int64_t>(reader.getUnsigned());
+
+        const auto step = base != nullptr ? static_cast<int32_t>(reader.getUnsigned()) : 0;
+
+        // A segment takes 3 bits at least
+        if (length < 0 || static_cast<uint64_t>(length) * 3u > reader.remainingBits()) {
+            return std::nullopt;
+        }
+
+        snake.resize(static_cast<size_t>(length));
+
+        for (size_t j = 0u; j < snake.size(); j++) {
+            const auto reference = expectedSegment(snake, base, step, j);
+            auto& segment = snake[j];
+
+            segment.x = reference.x + static_cast<int32_t>(reader.getSigned());
+            segment.y = reference.y + static_cast<int32_t>(reader.getSigned());
+            segment.direction = reader.getBool() ? static_cast<Direction>(reader.getBits(2u)) : reference.direction;
+        }
+    }
+
+    if (baseline == nullptr) {
+        auto fruits = decodeSorted(reader, BOARD_MAX_SIZE * BOARD_MAX_SIZE);
+        if (!fruits) {
+            return std::nullopt;
+        }
+
+        state.fruits = std::move(*fruits);
+
+        return state;
+    }
+
+    const auto removed = decodeSorted(reader, baseline->fruits.size());
+    const auto added = decodeSorted(reader, BOARD_MAX_SIZE * BOARD_MAX_SIZE);
+    if (!removed || !added || (!removed->empty() && removed->back() >= baseline->fruits.size())) {
+        return std::nullopt;
+    }
+
+    for (uint32_t i = 0u, next = 0u; i < baseline->fruits.size(); i++) {
+        if (next < removed->size() && (*removed)[next] == i) {
+            next++;
+        } else {
+            state.fruits.push_back(baseline->fruits[i]);
+        }
+    }
+
+    const auto kept = static_cast<std::ptrdiff_t>(state.fruits.size());
+    state.fruits.insert(state.fruits.end(), added->begin(), added->end());
+    std::ranges::inplace_merge(state.fruits, state.fruits.begin() + kept);
+
+    if (reader.failed()) {
+        return std::nullopt;
+    }
+
+    return state;
+}
+
+} // namespace snek
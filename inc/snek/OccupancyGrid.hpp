@@ -0,0 +1,559 @@
+/**
+ * @file OccupancyGrid.hpp
+ * 
+ * @brief Persistent per-cell occupancy index of the board, used for O(1) collision and placement queries.
+ * 
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "snek/constants.hpp"
+
+namespace snek {
+
+namespace detail {
+
+/**
+ * @brief SELECT_IN_BYTE[byte | rank << 8] is the position of the rank-th set bit of byte.
+ */
+inline constexpr auto SELECT_IN_BYTE = [] {
+    std::array<uint8_t, 256u * 8u> table{};
+
+    for (uint32_t byte = 0u; byte < 256u; byte++) {
+        uint32_t rank = 0u;
+
+        for (uint32_t bit = 0u; bit < 8u; bit++) {
+            if ((byte >> bit & 1u) != 0u) {
+                table[byte | (rank++ << 8u)] = static_cast<uint8_t>(bit);
+            }
+        }
+    }
+
+    return table;
+}();
+
+} // namespace detail
+
+/**
+ * @brief Tracks static content (rocks, fruits) as per-cell flags and snake segments
+ * as intrusive doubly linked lists per cell.
+ *
+ * Segments are identified by a caller-chosen index and keyed by the cell their center
+ * lies in. Relinking a segment is O(1), so the grid can follow the snake incrementally.
+ *
+ * Cells are stored in square chunks allocated on first write, so huge mostly empty boards
+ * stay cheap. Untouched chunks all read from one shared empty chunk at offset 0, a lookup
+ * is two loads without a branch. Segment heads get their own chunks, only where the snake
+ * has been. Cell ids are chunk-major (chunk * CHUNK_CELLS + local index), callers treat
+ * them as opaque.
+ *
+ * Each chunk keeps an occupancy bitmask with free counts per row and per 8 rows, and the
+ * per-chunk free counts are summed in a Fenwick tree. The i-th free cell (and thus a
+ * uniformly random one) is found in O(log chunks) for the chunk, then in constant time
+ * within it. Which cell is the i-th only depends on what is occupied, not on the order
+ * cells were occupied in, so a board restored from a saved state spawns the same cells.
+ */
+class OccupancyGrid {
+public:
+    enum Flag : uint8_t {
+        Rock  = 1u << 0,
+        Fruit = 1u << 1
+    };
+
+    static constexpr int32_t NONE = -1;
+
+    static constexpr uint32_t CHUNK_SHIFT = 6u; // 64x64 cells per chunk
+    static constexpr uint32_t CHUNK_SIZE = 1u << CHUNK_SHIFT;
+    static constexpr uint32_t CHUNK_CELLS = CHUNK_SIZE * CHUNK_SIZE;
+    static constexpr uint32_t BLOCK_ROWS = 8u; // rows per free count block of a chunk
+    static constexpr uint32_t CHUNK_BLOCKS = CHUNK_SIZE / BLOCK_ROWS;
+
+    OccupancyGrid() = default;
+
+    OccupancyGrid(uint32_t width, uint32_t height)
+        : m_width(width)
+        , m_height(height)
+        , m_row_shift(static_cast<uint32_t>(std::bit_width(((width + CHUNK_SIZE - 1u) >> CHUNK_SHIFT) - 1u)))
+        , m_chunks_y((height + CHUNK_SIZE - 1u) >> CHUNK_SHIFT)
+        , m_flag_base(static_cast<size_t>(m_chunks_y) << m_row_shift, 0u)
+        , m_segment_base(static_cast<size_t>(m_chunks_y) << m_row_shift, 0u)
+        , m_free_tree(std::bit_ceil(static_cast<size_t>(m_chunks_y) << m_row_shift), 0u)
+        , m_free_count(width * height)
+        , m_flags(CHUNK_CELLS, 0u)
+        , m_occupied(CHUNK_CELLS / 64u, 0u)
+        , m_row_free(CHUNK_SIZE, 0u)
+        , m_block_free(CHUNK_BLOCKS, 0u)
+        , m_first_segment(CHUNK_CELLS, NONE)
+    {
+        for (uint32_t chunk = 0u; chunk < m_flag_base.size(); chunk++) {
+            addFree(chunk, static_cast<int32_t>(cellsInBoard(chunk)));
+        }
+    }
+
+    auto getWidth() const -> uint32_t {
+        return m_width;
+    }
+
+    auto getHeight() const -> uint32_t {
+        return m_height;
+    }
+
+    auto getCellCount() const -> uint32_t {
+        return m_width * m_height;
+    }
+
+    /**
+     * @brief Chunks actually allocated so far, each costs about CHUNK_CELLS bytes (5x that with segments).
+     */
+    auto getAllocatedChunkCount() const -> uint32_t {
+        return static_cast<uint32_t>(m_flags.size() / CHUNK_CELLS - 1u);
+    }
+
+    auto contains(int32_t x, int32_t y) const -> bool {
+        return x >= 0 && x < static_cast<int32_t>(m_width) &&
+               y >= 0 && y < static_cast<int32_t>(m_height);
+    }
+
+    auto cellIndex(uint32_t x, uint32_t y) const -> uint32_t {
+        const uint32_t chunk = ((y >> CHUNK_SHIFT) << m_row_shift) + (x >> CHUNK_SHIFT);
+        const uint32_t local = ((y & (CHUNK_SIZE - 1u)) << CHUNK_SHIFT) | (x & (CHUNK_SIZE - 1u));
+
+        return (chunk << (2u * CHUNK_SHIFT)) | local;
+    }
+
+    /**
+     * @brief Cell containing the given point in board pixels, nullopt when outside the board.
+     */
+    auto cellAt(sf::Vector2f position) const -> std::optional<uint32_t> {
+        if (position.x < 0.f || position.y < 0.f) {
+            return std::nullopt;
+        }
+
+        const auto x = static_cast<int32_t>(position.x / snek::TILE_SIZE);
+        const auto y = static_cast<int32_t>(position.y / snek::TILE_SIZE);
+
+        if (!contains(x, y)) {
+            return std::nullopt;
+        }
+
+        return cellIndex(static_cast<uint32_t>(x), static_cast<uint32_t>(y));
+    }
+
+    auto cellCoords(uint32_t cell) const -> sf::Vector2u {
+        const auto origin = chunkOrigin(cell >> (2u * CHUNK_SHIFT));
+        const uint32_t local = cell & (CHUNK_CELLS - 1u);
+
+        return {origin.x + (local & (CHUNK_SIZE - 1u)), origin.y + (local >> CHUNK_SHIFT)};
+    }
+
+    auto cellCenter(uint32_t cell) const -> sf::Vector2f {
+        const auto coords = cellCoords(cell);
+
+        return {
+            coords.x * snek::TILE_SIZE + snek::TILE_SIZE / 2.f,
+            coords.y * snek::TILE_SIZE + snek::TILE_SIZE / 2.f
+        };
+    }
+
+    /**
+     * @brief Calls fn(cell) for every in-bounds cell of the 3x3 block centered on the given cell.
+     */
+    template<typename Fn>
+    auto forEachNeighbourhoodCell(uint32_t cell, Fn&& fn) const -> void {
+        const uint32_t local = cell & (CHUNK_CELLS - 1u);
+        const uint32_t local_x = local & (CHUNK_SIZE - 1u);
+        const uint32_t local_y = local >> CHUNK_SHIFT;
+
+        // Common case, the block lies inside the cell's own chunk: neighbours are plain offsets.
+        // Padding cells past the board edge can't be inside, the board's last cell is in range.
+        if (local_x - 1u < CHUNK_SIZE - 2u && local_y - 1u < CHUNK_SIZE - 2u) {
+            const auto coords = cellCoords(cell);
+            if (coords.x + 1u < m_width && coords.y + 1u < m_height) {
+                for (uint32_t row = cell - CHUNK_SIZE; row <= cell + CHUNK_SIZE; row += CHUNK_SIZE) {
+                    fn(row - 1u);
+                    fn(row);
+                    fn(row + 1u);
+                }
+
+                return;
+            }
+        }
+
+        const auto coords = cellCoords(cell);
+        const auto cx = static_cast<int32_t>(coords.x);
+        const auto cy = static_cast<int32_t>(coords.y);
+
+        for (int32_t dy = -1; dy <= 1; dy++) {
+            for (int32_t dx = -1; dx <= 1; dx++) {
+                if (contains(cx + dx, cy + dy)) {
+                    fn(cellIndex(static_cast<uint32_t>(cx + dx), static_cast<uint32_t>(cy + dy)));
+                }
+            }
+        }
+    }
+
+    // Static content
+
+    auto hasFlag(uint32_t cell, Flag flag) const -> bool {
+        return (getFlags(cell) & flag) != 0u;
+    }
+
+    auto getFlags(uint32_t cell) const -> uint8_t {
+        return m_flags[flagIndex(cell)];
+    }
+
+    auto setFlag(uint32_t cell, Flag flag) -> void {
+        allocateChunk(cell);
+
+        m_flags[flagIndex(cell)] |= flag;
+        refreshFree(cell);
+    }
+
+    auto clearFlag(uint32_t cell, Flag flag) -> void {
+        const size_t index = flagIndex(cell);
+
+        if (index >= CHUNK_CELLS) {
+            m_flags[index] &= static_cast<uint8_t>(~flag);
+            refreshFree(cell);
+        }
+    }
+
+    // Snake segments
+
+    auto hasSegment(uint32_t cell) const -> bool {
+        return m_first_segment[segmentIndex(cell)] != NONE;
+    }
+
+    auto isOccupied(uint32_t cell) const -> bool {
+        const size_t index = flagIndex(cell);
+
+        return (m_occupied[index >> 6u] >> (index & 63u) & 1u) != 0u;
+    }
+
+    /**
+     * @brief Places or relinks a segment, nullopt removes it from the grid (e.g. off-board).
+     */
+    auto moveSegment(uint32_t segment, std::optional<uint32_t> cell) -> void {
+        if (segment >= m_segment_cell.size()) {
+            m_segment_cell.resize(segment + 1u, NONE);
+            m_segment_next.resize(segment + 1u, NONE);
+            m_segment_prev.resize(segment + 1u, NONE);
+        }
+
+        const int32_t target = cell ? static_cast<int32_t>(*cell) : NONE;
+
+        if (m_segment_cell[segment] == target) {
+            return;
+        }
+
+        unlink(segment);
+
+        if (target != NONE) {
+            link(segment, static_cast<uint32_t>(target));
+        }
+    }
+
+    auto removeSegment(uint32_t segment) -> void {
+        if (segment < m_segment_cell.size()) {
+            unlink(segment);
+        }
+    }
+
+    auto clearSegments() -> void {
+        for (uint32_t segment = 0u; segment < m_segment_cell.size(); segment++) {
+            unlink(segment);
+        }
+    }
+
+    // Free cells
+
+    auto getFreeCellCount() const -> uint32_t {
+        return m_free_count;
+    }
+
+    /**
+     * @brief The i-th free cell in chunk order, any i below getFreeCellCount() is valid.
+     *
+     * O(log chunks) to find the chunk, at most 15 steps on the largest board and one on
+     * boards of a single chunk. Within a touched chunk it takes at most 8 block counts,
+     * 8 row counts and a broadword select. The order changes as cells get occupied and
+     * released.
+     */
+    auto getFreeCell(uint32_t i) const -> uint32_t {
+        // Where a random i lands is unpredictable, so every step below is branchless.
+        // Fenwick descent to the chunk holding the i-th free cell, the tree is padded
+        // to a power of two with chunks that have no free cells.
+        uint32_t chunk = 0u;
+
+        for (auto step = static_cast<uint32_t>(m_free_tree.size()); step > 0u; step >>= 1u) {
+            const uint32_t free = m_free_tree[chunk + step - 1u];
+            const bool past = free <= i;
+
+            chunk += past ? step : 0u;
+            i -= past ? free : 0u;
+        }
+
+        const uint32_t base = chunk << (2u * CHUNK_SHIFT);
+
+        if (m_flag_base[chunk] == 0u) {
+            // Untouched, every in-board cell is free in row-major order
+            const uint32_t row_width = std::min(CHUNK_SIZE, m_width - chunkOrigin(chunk).x);
+
+            return base + ((i / row_width) << CHUNK_SHIFT) + i % row_width;
+        }
+
+        const uint32_t block = selectCount(&m_block_free[m_flag_base[chunk] / CHUNK_CELLS * CHUNK_BLOCKS], i);
+
+        // One mask word is one chunk row
+        const size_t rows = m_flag_base[chunk] / 64u + block * BLOCK_ROWS;
+        const uint32_t row = selectCount(&m_row_free[rows], i);
+
+        return base + ((block * BLOCK_ROWS + row) << 6u) + nthSetBit(~m_occupied[rows + row], i);
+    }
+
+    /**
+     * @brief Calls fn(segment) for every segment whose center lies in the cell.
+     */
+    template<typename Fn>
+    auto forEachSegment(uint32_t cell, Fn&& fn) const -> void {
+        for (int32_t segment = m_first_segment[segmentIndex(cell)]; segment != NONE; segment = m_segment_next[segment]) {
+            fn(static_cast<uint32_t>(segment));
+        }
+    }
+private:
+    auto chunkOrigin(uint32_t chunk) const -> sf::Vector2u {
+        return {(chunk & ((1u << m_row_shift) - 1u)) << CHUNK_SHIFT, (chunk >> m_row_shift) << CHUNK_SHIFT};
+    }
+
+    // Offsets of the cell in the flag / occupancy pools and in the segment head pool
+    auto flagIndex(uint32_t cell) const -> size_t {
+        return m_flag_base[cell >> (2u * CHUNK_SHIFT)] + (cell & (CHUNK_CELLS - 1u));
+    }
+
+    auto segmentIndex(uint32_t cell) const -> size_t {
+        return m_segment_base[cell >> (2u * CHUNK_SHIFT)] + (cell & (CHUNK_CELLS - 1u));
+    }
+
+    auto allocateChunk(uint32_t cell) -> void {
+        const uint32_t chunk = cell >> (2u * CHUNK_SHIFT);
+
+        if (m_flag_base[chunk] != 0u) {
+            return;
+        }
+
+        const size_t base = m_flags.size();
+        m_flag_base[chunk] = static_cast<uint32_t>(base);
+        m_flags.resize(base + CHUNK_CELLS, 0u);
+        m_occupied.resize((base + CHUNK_CELLS) / 64u, 0u);
+        m_row_free.resize((base + CHUNK_CELLS) / 64u, 0u);
+        m_block_free.resize((base + CHUNK_CELLS) / CHUNK_CELLS * CHUNK_BLOCKS, 0u);
+
+        // Cells past the board edge are never free, one mask word is one chunk row
+        static_assert(CHUNK_SIZE == 64u);
+
+        const auto origin = chunkOrigin(chunk);
+        const uint32_t columns = std::min(CHUNK_SIZE, m_width - origin.x);
+        const uint64_t padding = columns == CHUNK_SIZE ? 0u : ~uint64_t{0u} << columns;
+
+        for (uint32_t row = 0u; row < CHUNK_SIZE; row++) {
+            const bool in_board = origin.y + row < m_height;
+
+            m_occupied[base / 64u + row] = in_board ? padding : ~uint64_t{0u};
+            m_row_free[base / 64u + row] = static_cast<uint8_t>(in_board ? columns : 0u);
+            m_block_free[base / CHUNK_CELLS * CHUNK_BLOCKS + row / BLOCK_ROWS] += static_cast<uint16_t>(in_board ? columns : 0u);
+        }
+    }
+
+    auto allocateSegmentChunk(uint32_t cell) -> void {
+        const uint32_t chunk = cell >> (2u * CHUNK_SHIFT);
+
+        if (m_segment_base[chunk] != 0u) {
+            return;
+        }
+
+        m_segment_base[chunk] = static_cast<uint32_t>(m_first_segment.size());
+        m_first_segment.resize(m_first_segment.size() + CHUNK_CELLS, NONE);
+    }
+
+    auto cellsInBoard(uint32_t chunk) const -> uint32_t {
+        const auto origin = chunkOrigin(chunk);
+
+        if (origin.x >= m_width) {
+            return 0u; // row stride padding, never part of the board
+        }
+
+        return std::min(CHUNK_SIZE, m_width - origin.x) * std::min(CHUNK_SIZE, m_height - origin.y);
+    }
+
+    auto addFree(uint32_t chunk, int32_t delta) -> void {
+        for (uint32_t i = chunk + 1u; i <= m_free_tree.size(); i += i & (~i + 1u)) {
+            m_free_tree[i - 1u] = static_cast<uint32_t>(static_cast<int32_t>(m_free_tree[i - 1u]) + delta);
+        }
+    }
+
+    /**
+     * @brief Which of 8 counts the i-th item falls in, i becomes its index within that count.
+     *
+     * Compares i with every prefix sum instead of stopping at the right one, no branch to mispredict.
+     */
+    template<typename Count>
+    static auto selectCount(const Count* counts, uint32_t& i) -> uint32_t {
+        static_assert(CHUNK_BLOCKS == 8u && BLOCK_ROWS == 8u);
+
+        uint32_t index = 0u;
+        uint32_t before = 0u;
+        uint32_t sum = 0u;
+
+        for (uint32_t k = 0u; k + 1u < 8u; k++) {
+            sum += counts[k];
+
+            const bool past = i >= sum;
+            index += past;
+            before = past ? sum : before;
+        }
+
+        i -= before;
+
+        return index;
+    }
+
+    /**
+     * @brief Position of the n-th set bit (from 0), bits must have more than n of them.
+     *
+     * Broadword select: the per-byte bit counts summed by one multiply locate the byte,
+     * a table the bit within it. No popcount, builds without -mpopcnt would call out for it.
+     */
+    static auto nthSetBit(uint64_t bits, uint32_t n) -> uint32_t {
+        constexpr uint64_t BYTES_ONE = 0x0101010101010101ull;
+        constexpr uint64_t BYTES_HIGH = 0x8080808080808080ull;
+
+        uint64_t counts = bits - ((bits >> 1u) & 0x5555555555555555ull);
+        counts = (counts & 0x3333333333333333ull) + ((counts >> 2u) & 0x3333333333333333ull);
+        counts = (counts + (counts >> 4u)) & 0x0F0F0F0F0F0F0F0Full;
+
+        // Byte k of sums counts the set bits of bytes 0 to k, the bytes summing to at most n precede the bit
+        const uint64_t sums = counts * BYTES_ONE;
+        const uint64_t preceding = (((n * BYTES_ONE) | BYTES_HIGH) - sums) & BYTES_HIGH;
+
+        const auto byte = static_cast<uint32_t>(((preceding >> 7u) * BYTES_ONE) >> 56u) * 8u;
+        const auto rank = n - static_cast<uint32_t>(((sums << 8u) >> byte) & 0xFFu);
+
+        return byte + detail::SELECT_IN_BYTE[((bits >> byte) & 0xFFu) | (rank << 8u)];
+    }
+
+    auto link(uint32_t segment, uint32_t cell) -> void {
+        allocateSegmentChunk(cell);
+
+        auto& head = m_first_segment[segmentIndex(cell)];
+        const int32_t first = head;
+
+        m_segment_cell[segment] = static_cast<int32_t>(cell);
+        m_segment_prev[segment] = NONE;
+        m_segment_next[segment] = first;
+
+        if (first != NONE) {
+            m_segment_prev[first] = static_cast<int32_t>(segment);
+        }
+
+        head = static_cast<int32_t>(segment);
+
+        refreshFree(cell);
+    }
+
+    auto unlink(uint32_t segment) -> void {
+        const int32_t cell = m_segment_cell[segment];
+
+        if (cell == NONE) {
+            return;
+        }
+
+        const int32_t prev = m_segment_prev[segment];
+        const int32_t next = m_segment_next[segment];
+
+        if (prev != NONE) {
+            m_segment_next[prev] = next;
+        } else {
+            m_first_segment[segmentIndex(static_cast<uint32_t>(cell))] = next;
+        }
+
+        if (next != NONE) {
+            m_segment_prev[next] = prev;
+        }
+
+        m_segment_cell[segment] = NONE;
+        m_segment_prev[segment] = NONE;
+        m_segment_next[segment] = NONE;
+
+        refreshFree(static_cast<uint32_t>(cell));
+    }
+
+    /**
+     * @brief Brings the occupancy mask and free counts in line with the cell's content.
+     */
+    auto refreshFree(uint32_t cell) -> void {
+        allocateChunk(cell);
+
+        const size_t index = flagIndex(cell);
+        const bool occupied = m_flags[index] != 0u || hasSegment(cell);
+
+        auto& word = m_occupied[index / 64u];
+        const uint64_t bit = uint64_t{1u} << (index & 63u);
+
+        if (occupied == ((word & bit) != 0u)) {
+            return;
+        }
+
+        word ^= bit;
+
+        const uint32_t chunk = cell >> (2u * CHUNK_SHIFT);
+        auto& row_free = m_row_free[index / 64u];
+        auto& block_free = m_block_free[index / (CHUNK_SIZE * BLOCK_ROWS)];
+
+        if (occupied) {
+            addFree(chunk, -1);
+            row_free--;
+            block_free--;
+            m_free_count--;
+        } else {
+            addFree(chunk, 1);
+            row_free++;
+            block_free++;
+            m_free_count++;
+        }
+    }
+
+    uint32_t m_width{0u};
+    uint32_t m_height{0u};
+    uint32_t m_row_shift{0u}; // chunk rows are a power of two chunks apart, no division per lookup
+    uint32_t m_chunks_y{0u};
+
+    // Per chunk: pool offsets (0, the shared empty chunk, while untouched) and the free count
+    // tree, padded to a power of two
+    std::vector<uint32_t> m_flag_base;
+    std::vector<uint32_t> m_segment_base;
+    std::vector<uint32_t> m_free_tree;
+    uint32_t m_free_count{0u};
+
+    // Pools of chunk storage, CHUNK_CELLS entries per chunk, never shrink
+    std::vector<uint8_t> m_flags;
+    std::vector<uint64_t> m_occupied; // flags or segments, padding cells count as occupied
+    std::vector<uint8_t> m_row_free;    // free cells per m_occupied word
+    std::vector<uint16_t> m_block_free; // CHUNK_BLOCKS per chunk
+    std::vector<int32_t> m_first_segment;
+
+    // Per segment
+    std::vector<int32_t> m_segment_cell;
+    std::vector<int32_t> m_segment_next;
+    std::vector<int32_t> m_segment_prev;
+}; // class OccupancyGrid
+
+} // namespace snek
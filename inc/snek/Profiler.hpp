@@ -0,0 +1,185 @@
+/**
+ * @file Profiler.hpp
+ * 
+ * @brief Low-overhead scoped-timer instrumentation with Chrome trace_event export.
+ *
+ * Only compiled in when SNEK_PROFILING is defined (CMake option SNEK_ENABLE_PROFILER),
+ * otherwise SNEK_PROFILE_SCOPE expands to nothing and the profiler costs nothing.
+ * 
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace snek::profiler {
+
+/**
+ * @brief Whether the instrumentation is compiled in.
+ */
+constexpr bool ENABLED =
+#ifdef SNEK_PROFILING
+    true;
+#else
+    false;
+#endif
+
+struct Event {
+    const char* name; // string literal, never owned
+    uint64_t startNs;
+    uint64_t durationNs;
+};
+
+/**
+ * @brief Fixed-size ring of the most recent events of one thread.
+ *
+ * Only its owning thread writes to it. Dumping while other threads are still
+ * recording may pick up a few torn events right at the ring's wrap point.
+ */
+class ThreadBuffer {
+public:
+    static constexpr uint64_t CAPACITY = 1u << 16;
+
+    explicit ThreadBuffer(uint32_t thread_id)
+        : m_thread_id(thread_id)
+    {}
+
+    auto push(const Event& event) -> void {
+        const auto count = m_count.load(std::memory_order_relaxed);
+
+        m_events[count % CAPACITY] = event;
+        m_count.store(count + 1u, std::memory_order_release);
+    }
+
+    template<typename Fn>
+    auto forEach(Fn&& fn) const -> void {
+        const auto count = m_count.load(std::memory_order_acquire);
+        const auto first = count > CAPACITY ? count - CAPACITY : 0u;
+
+        for (uint64_t i = first; i < count; i++) {
+            fn(m_events[i % CAPACITY]);
+        }
+    }
+
+    auto getThreadId() const -> uint32_t {
+        return m_thread_id;
+    }
+private:
+    std::array<Event, CAPACITY> m_events;
+    std::atomic<uint64_t> m_count{0u};
+    uint32_t m_thread_id;
+}; // class ThreadBuffer
+
+inline auto nowNs() -> uint64_t {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+class Profiler {
+public:
+    /**
+     * @brief Ring buffer of the calling thread, registered on first use.
+     *
+     * Buffers are owned by the profiler, events of finished threads can still be dumped.
+     */
+    static auto threadBuffer() -> ThreadBuffer& {
+        thread_local ThreadBuffer* buffer = instance().registerThread();
+
+        return *buffer;
+    }
+
+    /**
+     * @brief Writes every recorded event as Chrome trace_event JSON (chrome://tracing, Perfetto).
+     */
+    static auto writeChromeTrace(std::string_view path) -> bool {
+        auto& self = instance();
+        const std::lock_guard lock(self.m_mutex);
+
+        std::FILE* file = std::fopen(std::string(path).c_str(), "w");
+        if (file == nullptr) {
+            std::println(stderr, "Failed to open trace file: {}", path);
+
+            return false;
+        }
+
+        std::println(file, "{{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+        bool first = true;
+        for (const auto& buffer : self.m_buffers) {
+            buffer->forEach([&](const Event& event) {
+                std::print(file, "{}{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                    first ? "" : ",\n",
+                    event.name,
+                    buffer->getThreadId(),
+                    static_cast<double>(event.startNs - self.m_epoch_ns) / 1000.0,
+                    static_cast<double>(event.durationNs) / 1000.0);
+                first = false;
+            });
+        }
+
+        std::println(file, "\n]}}");
+        std::fclose(file);
+
+        return true;
+    }
+private:
+    static auto instance() -> Profiler& {
+        static Profiler instance;
+        return instance;
+    }
+
+    auto registerThread() -> ThreadBuffer* {
+        const std::lock_guard lock(m_mutex);
+
+        const auto thread_id = static_cast<uint32_t>(m_buffers.size());
+
+        return m_buffers.emplace_back(std::make_unique<ThreadBuffer>(thread_id)).get();
+    }
+
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+    uint64_t m_epoch_ns{nowNs()};
+}; // class Profiler
+
+/**
+ * @brief Records the duration of the enclosing scope into the thread's ring buffer.
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(const char* name)
+        : m_name(name)
+        , m_start_ns(nowNs())
+    {}
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    auto operator=(const ScopedTimer&) -> ScopedTimer& = delete;
+
+    ~ScopedTimer() {
+        Profiler::threadBuffer().push({m_name, m_start_ns, nowNs() - m_start_ns});
+    }
+private:
+    const char* m_name;
+    uint64_t m_start_ns;
+}; // class ScopedTimer
+
+} // namespace snek::profiler
+
+#define SNEK_PROFILE_CONCAT_IMPL(a, b) a##b
+#define SNEK_PROFILE_CONCAT(a, b) SNEK_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef SNEK_PROFILING
+    #define SNEK_PROFILE_SCOPE(name) \
+        const ::snek::profiler::ScopedTimer SNEK_PROFILE_CONCAT(snek_profile_scope_, __LINE__){name}
+#else
+    #define SNEK_PROFILE_SCOPE(name) static_cast<void>(0)
+#endif
@@ -1,25 +1,37 @@
 /**
  * @file Renderer.hpp
  * 
- * @brief Renderer class responsible for drawing entities on the screen. 2D now.
+ * @brief Renderer class responsible for drawing entities on the screen. 2D now, sprites are batched per texture.
  * 
  * @authors Jacek Zub
  */
 #pragma once
 
 #include <SFML/Graphics/RenderWindow.hpp>
-#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/Graphics/VertexBuffer.hpp>
 #include <SFML/Graphics/Font.hpp>
 #include <SFML/Graphics/Text.hpp>
 #include <SFML/Graphics/Drawable.hpp>
 #include <SFML/System/Angle.hpp>
 
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <format>
 #include <memory>
+#include <optional>
+#include <span>
+#include <vector>
 
 #include <print>
 
 #include "snek/constants.hpp"
+#include "snek/Assets.hpp"
 #include "snek/Entity.hpp"
+#include "snek/TextureManager.hpp"
+#include "snek/AssetPack.hpp"
+#include "snek/Profiler.hpp"
 
 namespace snek {
 
@@ -30,37 +42,150 @@ public:
     {}
 
     auto setView(const sf::View& view) -> void {
+        flush();
         m_window.setView(view);
     }
 
+    /**
+     * @brief Sets how far between the last two simulation ticks entities are drawn.
+     */
+    auto setInterpolation(float alpha) -> void {
+        m_interpolation = alpha;
+    }
+
+    auto getInterpolation() const -> float {
+        return m_interpolation;
+    }
+
+    /**
+     * @brief Queues the entity into the sprite batch of its texture.
+     *
+     * Nothing reaches the window until the batch is flushed, which happens once at
+     * endFrame() or earlier when the view changes or a non-batched drawable is drawn.
+     */
     auto draw(const Entity* entity) -> void {
-        if (entity->texture == nullptr) {
-            std::println(stderr, "Entity has no texture, cannot draw.");
+        // Entities only carry a sprite handle, the atlas is resolved on the graphics side.
+        // Lazily, so screens without entities don't wait for the atlas to decode.
+        // Only a loaded atlas is kept, a missing one is looked up again next time.
+        if (m_atlas == nullptr) {
+            m_atlas = TextureManager::getTexture(TextureId::Atlas);
+        }
+
+        if (m_atlas == nullptr) {
+            if (!m_atlas_missing_reported) {
+                std::println(stderr, "Texture atlas is not loaded, cannot draw entities.");
+                m_atlas_missing_reported = true;
+            }
 
             return;
         }
 
-        sf::Sprite sprite(*entity->texture);
+        appendQuad(
+            batchFor(m_atlas),
+            interpolate(entity->previousPosition, entity->position),
+            entity->size,
+            entityAngle(*entity),
+            getSpriteRect(entity->sprite)
+        );
+    }
+
+    /**
+     * @brief Draws a range of prebuilt vertices (triangles) in one call, after the pending batches.
+     */
+    auto drawVertices(const sf::VertexBuffer& buffer, size_t first, size_t count, const sf::Texture* texture) -> void {
+        if (count == 0u) {
+            return;
+        }
 
-        const auto tileRect = getTextureRect(entity->textureIndex);
-        sprite.setTextureRect(tileRect);
+        flush();
+        m_window.draw(buffer, first, count, sf::RenderStates{texture});
+        m_stats.drawCalls++;
+    }
 
-        const sf::Vector2f spriteSize{
-            static_cast<float>(tileRect.size.x),
-            static_cast<float>(tileRect.size.y)
-        };
+    /**
+     * @brief Same for client-side vertices, where vertex buffers aren't available.
+     */
+    auto drawVertices(std::span<const sf::Vertex> vertices, const sf::Texture* texture) -> void {
+        if (vertices.empty()) {
+            return;
+        }
 
-        sprite.setOrigin(spriteSize / 2.f);
-        sprite.setScale({
-            entity->size.x / spriteSize.x,
-            entity->size.y / spriteSize.y
-        });
-        sprite.setPosition(entity->position);
-        const float angle = (static_cast<float>(entity->direction) - 1.f) * 90.f
-            + entity->rotationOffsetDegrees;
-        sprite.setRotation(sf::degrees(angle));
+        flush();
+        m_window.draw(vertices.data(), vertices.size(), sf::PrimitiveType::Triangles, sf::RenderStates{texture});
+        m_stats.drawCalls++;
+    }
 
-        m_window.draw(sprite);
+    /**
+     * @brief Rotation an entity is drawn with, sprites face right when it's 0.
+     */
+    static auto entityAngle(const Entity& entity) -> sf::Angle {
+        return sf::degrees((static_cast<float>(entity.direction) - 1.f) * 90.f + entity.rotationOffsetDegrees);
+    }
+
+    /**
+     * @brief A rotated, textured quad as two triangles, transformed on the CPU.
+     */
+    static auto spriteQuad(
+        sf::Vector2f center,
+        sf::Vector2f size,
+        sf::Angle angle,
+        sf::IntRect tileRect
+    ) -> std::array<sf::Vertex, 6> {
+        const float c = std::cos(angle.asRadians());
+        const float s = std::sin(angle.asRadians());
+
+        const sf::Vector2f half = size / 2.f;
+        const sf::Vector2f ax{ half.x * c, half.x * s}; // rotated half width
+        const sf::Vector2f ay{-half.y * s, half.y * c}; // rotated half height
+
+        const sf::Vector2f topLeft     = center - ax - ay;
+        const sf::Vector2f topRight    = center + ax - ay;
+        const sf::Vector2f bottomRight = center + ax + ay;
+        const sf::Vector2f bottomLeft  = center - ax + ay;
+
+        const float left   = static_cast<float>(tileRect.position.x);
+        const float top    = static_cast<float>(tileRect.position.y);
+        const float right  = left + static_cast<float>(tileRect.size.x);
+        const float bottom = top + static_cast<float>(tileRect.size.y);
+
+        return {{
+            {topLeft,     sf::Color::White, {left,  top}},
+            {topRight,    sf::Color::White, {right, top}},
+            {bottomRight, sf::Color::White, {right, bottom}},
+            {topLeft,     sf::Color::White, {left,  top}},
+            {bottomRight, sf::Color::White, {right, bottom}},
+            {bottomLeft,  sf::Color::White, {left,  bottom}},
+        }};
+    }
+
+    /**
+     * @brief Submits every non-empty sprite batch with a single draw call per texture.
+     */
+    auto flush() -> void {
+        SNEK_PROFILE_SCOPE("Renderer::flush");
+
+        for (auto& batch : m_batches) {
+            if (batch.vertices.getVertexCount() == 0u) {
+                continue;
+            }
+
+            m_window.draw(batch.vertices, sf::RenderStates{batch.texture});
+            m_stats.drawCalls++;
+
+            batch.vertices.clear(); // keeps the capacity for the next frame
+        }
+    }
+
+    struct FrameStats {
+        uint32_t drawCalls{0u};
+        uint32_t sprites{0u};
+    };
+
+    /**
+     * @brief Counters of the frame in progress, reset by beginFrame().
+     */
+    auto getStats() const -> const FrameStats& {
+        return m_stats;
     }
 
     struct DrawTextProps {
@@ -78,38 +203,75 @@ public:
         text.setFillColor(props.fillColor);
         text.setPosition(props.position);
 
+        flush();
         m_window.draw(text);
+        m_stats.drawCalls++;
     }
 
-    auto debugText(const std::vector<std::string>& lines) -> void {
-        auto& font = getFont();
-
-        float y_offset = 5.f;
-        const float x_offset = 5.f;
+    static constexpr size_t TEXT_SLOT_CAPACITY = 128u;
 
-        for (const auto& line : lines) {
-            sf::Text text(font, line);
+    struct CachedTextProps {
+        sf::Vector2f position{5.f, 5.0f};
+        uint32_t characterSize{20u};
+        sf::Color fillColor{sf::Color::White};
+    };
 
-            text.setCharacterSize(20);
-            text.setFillColor(sf::Color::White);
-            text.setPosition({x_offset, y_offset});
+    /**
+     * @brief Draws text kept in a persistent slot, re-laid out only when its content changes.
+     *
+     * The text is formatted into the slot's fixed buffer (truncated to TEXT_SLOT_CAPACITY - 1
+     * characters). When it matches what the slot showed before, the already built glyph
+     * geometry is drawn as is, no string or sf::Text is created.
+     */
+    template<typename... Args>
+    auto cachedText(
+        uint32_t slot,
+        const CachedTextProps& props,
+        std::format_string<Args...> fmt,
+        Args&&... args
+    ) -> void {
+        auto& text_slot = textSlot(slot);
+
+        std::array<char, TEXT_SLOT_CAPACITY> buffer;
+        const auto result = std::format_to_n(buffer.data(), buffer.size() - 1u, fmt, std::forward<Args>(args)...);
+        const auto length = static_cast<size_t>(result.out - buffer.data());
+        buffer[length] = '\0';
+
+        const bool changed = length != text_slot.length ||
+            std::memcmp(buffer.data(), text_slot.buffer.data(), length) != 0;
+
+        if (changed) {
+            text_slot.buffer = buffer;
+            text_slot.length = length;
+            text_slot.text->setString(text_slot.buffer.data());
+        }
 
-            m_window.draw(text);
+        text_slot.text->setCharacterSize(props.characterSize);
+        text_slot.text->setFillColor(props.fillColor);
+        text_slot.text->setPosition(props.position);
 
-            y_offset += 16.f;
-        }
+        flush();
+        m_window.draw(*text_slot.text);
+        m_stats.drawCalls++;
     }
 
     auto beginFrame() -> void {
+        m_stats = {};
+
         m_window.clear(sf::Color::Black);
     }
 
     auto endFrame() -> void {
+        flush();
+
+        SNEK_PROFILE_SCOPE("Renderer::display");
         m_window.display();
     }
 
     auto drawDrawable(const sf::Drawable& drawable) -> void {
+        flush();
         m_window.draw(drawable);
+        m_stats.drawCalls++;
     }
 
     auto getWindowSize() const -> sf::Vector2u {
@@ -117,27 +279,90 @@ public:
     }
 
     auto resetView() -> void {
+        flush();
         m_window.setView(m_window.getDefaultView());
     }
 
-    auto getFont() -> sf::Font& {
-        return font();
+    auto getFont(FontId id = FontId::Ui) -> sf::Font& {
+        return font(id);
     }
 private:
-    static auto font() -> sf::Font& {
-        static std::unique_ptr<sf::Font> font{nullptr};
+    static auto font(FontId id) -> sf::Font& {
+        static std::array<std::unique_ptr<sf::Font>, static_cast<size_t>(FontId::Count)> fonts;
 
+        auto& font = fonts[static_cast<size_t>(id)];
         if (!font) {
             font = std::make_unique<sf::Font>();
-            if (!font->openFromFile(snek::RESPATH_ARIAL_TTF)) {
-                std::println(stderr, "Failed to load font: {}", snek::RESPATH_ARIAL_TTF);
+            if (!loadAsset(*font, assetPath(id))) {
+                std::println(stderr, "Failed to load font: {}", assetPath(id));
             }
         }
 
         return *font;
     }
 
+    struct TextSlot {
+        std::optional<sf::Text> text; // sf::Text needs its font up front
+        std::array<char, TEXT_SLOT_CAPACITY> buffer{};
+        size_t length{0u};
+    };
+
+    auto textSlot(uint32_t slot) -> TextSlot& {
+        if (slot >= m_text_slots.size()) {
+            m_text_slots.resize(slot + 1u);
+        }
+
+        auto& text_slot = m_text_slots[slot];
+        if (!text_slot.text) {
+            text_slot.text.emplace(getFont());
+        }
+
+        return text_slot;
+    }
+
+    struct SpriteBatch {
+        const sf::Texture* texture;
+        sf::VertexArray vertices{sf::PrimitiveType::Triangles};
+    };
+
+    auto batchFor(const sf::Texture* texture) -> SpriteBatch& {
+        // Only a handful of textures ever exist, a linear scan beats hashing
+        for (auto& batch : m_batches) {
+            if (batch.texture == texture) {
+                return batch;
+            }
+        }
+
+        return m_batches.emplace_back(SpriteBatch{texture});
+    }
+
+    auto appendQuad(
+        SpriteBatch& batch,
+        sf::Vector2f center,
+        sf::Vector2f size,
+        sf::Angle angle,
+        sf::IntRect tileRect
+    ) -> void {
+        for (const auto& vertex : spriteQuad(center, size, angle, tileRect)) {
+            batch.vertices.append(vertex);
+        }
+
+        m_stats.sprites++;
+    }
+
+    auto interpolate(sf::Vector2f previous, sf::Vector2f current) const -> sf::Vector2f {
+        return previous + (current - previous) * m_interpolation;
+    }
+
     sf::RenderWindow& m_window;
+    float m_interpolation{1.f};
+
+    const sf::Texture* m_atlas{nullptr}; // until the first entity is drawn with the atlas loaded
+    bool m_atlas_missing_reported{false};
+    std::vector<SpriteBatch> m_batches;
+    FrameStats m_stats;
+
+    std::vector<TextSlot> m_text_slots;
 }; // class Renderer
 
 } // namespace snek
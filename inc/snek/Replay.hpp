@@ -0,0 +1,383 @@
+/**
+ * @file Replay.hpp
+ *
+ * @brief Deterministic input recordings of a Board, recorded live and played back headless.
+ *
+ * A Board is fully determined by its Config (including the seed) and the action fed
+ * to each update(), so a replay stores just that: the config and a run-length encoded
+ * stream of per-tick actions. Every keyframeInterval ticks a keyframe marks where the
+ * tick starts in the stream together with a digest of the board at that point, used
+ * for seeking and to detect desyncs during playback.
+ *
+ * File layout, little-endian:
+ *   header    "SNKR", version u32, width u32, height u32, rocks u32, tickRate u32, turnBuffer u32,
+ *             movement u8, seed u32, keyframeInterval u32, tickCount u64, runCount u32, keyframeCount u32
+ *   runs      runCount x (action u8, count varint)
+ *   keyframes keyframeCount x (tick u64, runIndex u32, digest u64)
+ *
+ * The standard library distributions are implementation defined, a replay reproduces
+ * only on builds using the same standard library.
+ *
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <print>
+#include <string_view>
+#include <vector>
+
+#include "snek/Board.hpp"
+#include "snek/ByteStream.hpp"
+#include "snek/InputAction.hpp"
+
+namespace snek {
+
+/**
+ * @brief FNV-1a digest of the observable board state, cheap enough to take every keyframe.
+ */
+inline auto digestBoard(const Board& board) -> uint64_t {
+    uint64_t hash = 0xCBF29CE484222325ull;
+
+    const auto mix = [&](uint64_t value) {
+        for (uint32_t i = 0u; i < 8u; i++) {
+            hash ^= (value >> (8u * i)) & 0xFFu;
+            hash *= 0x100000001B3ull;
+        }
+    };
+    const auto mixPosition = [&](sf::Vector2f position) {
+        mix(std::bit_cast<uint32_t>(position.x) | static_cast<uint64_t>(std::bit_cast<uint32_t>(position.y)) << 32u);
+    };
+
+    const auto& snake = board.getSnake();
+
+    mix(static_cast<uint64_t>(board.getState()));
+    mix(snake.getLength());
+    mix(static_cast<uint64_t>(snake.getHeading()));
+    mixPosition(snake.getHead().position);
+
+    for (const auto& rival : board.getArenaSnakes()) {
+        mix(rival.getLength());
+        mixPosition(rival.getHeadPosition());
+    }
+
+    board.getFruits().forEach([&](const Entity& fruit) {
+        mixPosition(fruit.position);
+    });
+
+    mix(board.getRocks().size());
+
+    return hash;
+}
+
+struct Replay {
+    static constexpr uint32_t VERSION = 4u; // 2: rock count, chunked board; 3: turn buffer; 4: grid turns per cell step
+    static constexpr uint32_t DEFAULT_KEYFRAME_INTERVAL = 600u; // 10 s at 60 Hz
+
+    struct Run {
+        InputAction action;
+        uint32_t count;
+    };
+
+    struct Keyframe {
+        uint64_t tick;
+        uint32_t runIndex; // keyframes always start a new run
+        uint64_t digest;   // digestBoard() right before the tick is applied
+    };
+
+    Board::Config config;
+    uint32_t keyframeInterval{DEFAULT_KEYFRAME_INTERVAL};
+    uint64_t tickCount{0u};
+    std::vector<Run> runs;
+    std::vector<Keyframe> keyframes;
+
+    auto save(std::string_view path) const -> bool {
+        ByteWriter writer;
+
+        writer.putBytes(MAGIC);
+        writer.put(VERSION);
+        writer.put(config.width);
+        writer.put(config.height);
+        writer.put(config.rocks);
+        writer.put(config.tickRate);
+        writer.put(config.turnBuffer);
+        writer.put(static_cast<uint8_t>(config.movement));
+        writer.put(config.seed.value_or(0u));
+        writer.put(keyframeInterval);
+        writer.put(tickCount);
+        writer.put(static_cast<uint32_t>(runs.size()));
+        writer.put(static_cast<uint32_t>(keyframes.size()));
+
+        for (const auto& run : runs) {
+            writer.put(static_cast<uint8_t>(run.action));
+            writer.putVarint(run.count);
+        }
+
+        for (const auto& keyframe : keyframes) {
+            writer.put(keyframe.tick);
+            writer.put(keyframe.runIndex);
+            writer.put(keyframe.digest);
+        }
+
+        return writer.writeFile(path);
+    }
+
+    static auto load(std::string_view path) -> std::optional<Replay> {
+        std::vector<uint8_t> bytes;
+        if (!readFile(path, bytes)) {
+            return std::nullopt;
+        }
+
+        ByteReader reader{bytes};
+
+        const bool magic_ok = std::ranges::all_of(MAGIC, [&](uint8_t byte) {
+            return reader.get<uint8_t>() == byte;
+        });
+        if (!magic_ok || reader.get<uint32_t>() != VERSION) {
+            std::println(stderr, "{} is not a snek replay of version {}", path, VERSION);
+
+            return std::nullopt;
+        }
+
+        Replay replay;
+        replay.config.width = reader.get<uint32_t>();
+        replay.config.height = reader.get<uint32_t>();
+        replay.config.rocks = reader.get<uint32_t>();
+        replay.config.tickRate = reader.get<uint32_t>();
+        replay.config.turnBuffer = reader.get<uint32_t>();
+        const auto movement = reader.get<uint8_t>();
+        replay.config.movement = static_cast<Snake::Movement>(movement);
+        replay.config.seed = reader.get<uint32_t>();
+        replay.keyframeInterval = reader.get<uint32_t>();
+        replay.tickCount = reader.get<uint64_t>();
+
+        const auto run_count = reader.get<uint32_t>();
+        const auto keyframe_count = reader.get<uint32_t>();
+
+        // Every run takes at least 2 bytes, don't trust the counts further than the file size
+        if (reader.failed() || run_count > reader.remaining() / 2u) {
+            std::println(stderr, "Corrupted replay header in {}", path);
+
+            return std::nullopt;
+        }
+
+        const auto& config = replay.config;
+        bool valid = replay.keyframeInterval > 0u && movement <= static_cast<uint8_t>(Snake::Movement::Grid) &&
+            config.tickRate >= 1u &&
+            config.width >= 1u && config.width <= BOARD_MAX_SIZE &&
+            config.height >= 1u && config.height <= BOARD_MAX_SIZE &&
+            config.rocks <= config.width * config.height &&
+            config.turnBuffer <= INPUT_TURN_BUFFER_MAX;
+
+        // Tick each run starts on, the last one is where the recorded ticks end
+        std::vector<uint64_t> run_starts{0u};
+        run_starts.reserve(run_count + 1u);
+
+        replay.runs.reserve(run_count);
+        for (uint32_t i = 0u; i < run_count && valid; i++) {
+            const auto action = reader.get<uint8_t>();
+            const auto count = reader.getVarint();
+
+            valid = action <= static_cast<uint8_t>(InputAction::None) && count > 0u && count <= UINT32_MAX;
+
+            replay.runs.push_back({static_cast<InputAction>(action), static_cast<uint32_t>(count)});
+            run_starts.push_back(run_starts.back() + count);
+        }
+
+        for (uint32_t i = 0u; i < keyframe_count && valid && !reader.failed(); i++) {
+            Keyframe keyframe;
+            keyframe.tick = reader.get<uint64_t>();
+            keyframe.runIndex = reader.get<uint32_t>();
+            keyframe.digest = reader.get<uint64_t>();
+
+            // The player finds keyframe i at tick i * keyframeInterval, at the start of its run
+            valid = keyframe.tick == i * static_cast<uint64_t>(replay.keyframeInterval) &&
+                keyframe.runIndex < run_count && run_starts[keyframe.runIndex] == keyframe.tick;
+
+            replay.keyframes.push_back(keyframe);
+        }
+
+        if (!valid || reader.failed() || replay.tickCount > run_starts.back()) {
+            std::println(stderr, "Corrupted replay data in {}", path);
+
+            return std::nullopt;
+        }
+
+        return replay;
+    }
+private:
+    static constexpr uint8_t MAGIC[4] = {'S', 'N', 'K', 'R'};
+}; // struct Replay
+
+/**
+ * @brief Records the actions fed to a Board, starting from its construction.
+ *
+ * Call record() with the same action right before every board.update(action).
+ */
+class ReplayRecorder {
+public:
+    explicit ReplayRecorder(const Board& board, uint32_t keyframe_interval = Replay::DEFAULT_KEYFRAME_INTERVAL) {
+        auto& config = m_replay.config;
+        config.width = board.getWidth();
+        config.height = board.getHeight();
+        config.rocks = board.getRequestedRocks();
+        config.tickRate = board.getTickRate();
+        config.turnBuffer = board.getTurnBufferDepth();
+        config.movement = board.getSnake().getMovement();
+        config.seed = board.getSeed();
+
+        m_replay.keyframeInterval = std::max(keyframe_interval, 1u);
+    }
+
+    auto record(const Board& board, InputAction action) -> void {
+        auto& runs = m_replay.runs;
+        const bool keyframe = m_replay.tickCount % m_replay.keyframeInterval == 0u;
+
+        if (keyframe) {
+            m_replay.keyframes.push_back({
+                m_replay.tickCount,
+                static_cast<uint32_t>(runs.size()),
+                digestBoard(board)
+            });
+        }
+
+        if (!keyframe && !runs.empty() && runs.back().action == action && runs.back().count < UINT32_MAX) {
+            runs.back().count++;
+        } else {
+            runs.push_back({action, 1u});
+        }
+
+        m_replay.tickCount++;
+    }
+
+    auto getReplay() const -> const Replay& {
+        return m_replay;
+    }
+private:
+    Replay m_replay;
+}; // class ReplayRecorder
+
+/**
+ * @brief Feeds a replay into its own Board, with seeking and desync detection.
+ *
+ * The flat states of boards reached at keyframes are kept in memory, seeking restores the
+ * nearest one at or before the target tick and simulates the rest, which runs at headless speed.
+ */
+class ReplayPlayer {
+public:
+    explicit ReplayPlayer(const Replay& replay)
+        : m_replay(replay)
+        , m_board(replay.config)
+    {}
+
+    auto getBoard() const -> const Board& {
+        return m_board;
+    }
+
+    auto getTick() const -> uint64_t {
+        return m_tick;
+    }
+
+    auto finished() const -> bool {
+        return m_tick >= m_replay.tickCount;
+    }
+
+    /**
+     * @brief First keyframe tick where the board didn't match the recording.
+     */
+    auto getDesyncTick() const -> std::optional<uint64_t> {
+        return m_desync_tick;
+    }
+
+    /**
+     * @brief Applies the next recorded tick.
+     *
+     * @return false when the replay is already finished.
+     */
+    auto step() -> bool {
+        if (finished() || m_run >= m_replay.runs.size()) {
+            return false;
+        }
+
+        const auto keyframe_index = m_tick / m_replay.keyframeInterval;
+        if (m_tick % m_replay.keyframeInterval == 0u && keyframe_index < m_replay.keyframes.size()) {
+            reachKeyframe(static_cast<size_t>(keyframe_index));
+        }
+
+        const auto& run = m_replay.runs[m_run];
+        m_board.update(run.action);
+
+        if (++m_run_offset == run.count) {
+            m_run++;
+            m_run_offset = 0u;
+        }
+
+        m_tick++;
+
+        return true;
+    }
+
+    /**
+     * @brief Moves playback to just before the given tick, clamped to the replay length.
+     */
+    auto seek(uint64_t tick) -> void {
+        tick = std::min(tick, m_replay.tickCount);
+
+        if (!m_snapshots.empty()) {
+            // Nearest keyframe already simulated at or before the target
+            const auto index = std::min(
+                static_cast<size_t>(tick / m_replay.keyframeInterval),
+                m_snapshots.size() - 1u);
+            const auto& keyframe = m_replay.keyframes[index];
+
+            if (tick < m_tick || keyframe.tick > m_tick) {
+                m_board.restoreState(m_snapshots[index]);
+                m_tick = keyframe.tick;
+                m_run = keyframe.runIndex;
+                m_run_offset = 0u;
+                m_skip_keyframe = true;
+            }
+        } else if (tick < m_tick) {
+            m_board = Board{m_replay.config};
+            m_tick = 0u;
+            m_run = 0u;
+            m_run_offset = 0u;
+        }
+
+        while (m_tick < tick) {
+            step();
+        }
+    }
+private:
+    auto reachKeyframe(size_t index) -> void {
+        if (m_skip_keyframe) {
+            m_skip_keyframe = false; // restored from this very keyframe
+
+            return;
+        }
+
+        if (!m_desync_tick && digestBoard(m_board) != m_replay.keyframes[index].digest) {
+            m_desync_tick = m_tick;
+        }
+
+        if (index == m_snapshots.size()) {
+            m_board.saveState(m_snapshots.emplace_back());
+        }
+    }
+
+    const Replay& m_replay;
+    Board m_board;
+
+    uint64_t m_tick{0u};
+    size_t m_run{0u};
+    uint32_t m_run_offset{0u};
+
+    std::vector<std::vector<uint8_t>> m_snapshots; // board state at the start of keyframe i
+    bool m_skip_keyframe{false};
+    std::optional<uint64_t> m_desync_tick;
+}; // class ReplayPlayer
+
+} // namespace snek
@@ -9,55 +9,86 @@
 
 #include <SFML/System/Vector2.hpp>
 
+#include <algorithm>
+#include <bit>
+#include <span>
 #include <vector>
-#include <memory>
 #include <ranges>
 
 #include "snek/constants.hpp"
 #include "snek/Entity.hpp"
-#include "snek/TextureManager.hpp"
+#include "snek/CellRing.hpp"
+#include "snek/Profiler.hpp"
+#include "snek/StateStream.hpp"
 
 namespace snek {
 
 class Snake {
+    /**
+     * @brief Point where the head turned, every segment behind it turns there as well.
+     *
+     * Pivots live in a ring buffer and are addressed by a monotonically increasing
+     * sequence number, the slot is seq & m_pivot_mask.
+     */
     struct Pivot {
         sf::Vector2f position;
         Direction direction;
-
-        std::shared_ptr<Pivot> next{nullptr};
-    };
-    
-    struct Segment {
-        Entity entity;
-
-        std::shared_ptr<Pivot> next_pivot{nullptr};
     };
 public:
+    /**
+     * @brief How the body follows the head.
+     *
+     * Free: segments move continuously and turn at pivots, a step costs O(length).
+     * Grid: the body is a ring of cells, a step pushes a head cell and pops the tail
+     *       cell, O(1) regardless of length. Segment positions are derived lazily.
+     */
+    enum class Movement {
+        Free,
+        Grid
+    };
+    
     Snake(
         uint32_t initial_len = SNAKE_INITIAL_LENGTH,
-        sf::Vector2f start_pos = {WINDOW_WIDTH / 2.f, WINDOW_HEIGHT / 2.f}
-    ) {
+        sf::Vector2f start_pos = {WINDOW_WIDTH / 2.f, WINDOW_HEIGHT / 2.f},
+        Movement movement = Movement::Free
+    )
+        : m_movement(movement)
+    {
+        if (m_movement == Movement::Grid) {
+            const sf::Vector2i head_cell{
+                static_cast<int32_t>(start_pos.x / snek::TILE_SIZE),
+                static_cast<int32_t>(start_pos.y / snek::TILE_SIZE)};
+
+            for (uint32_t i = 0u; i < initial_len; i++) {
+                m_cells.pushTail({{head_cell.x, head_cell.y + static_cast<int32_t>(i)}, Direction::Up});
+            }
+
+            return;
+        }
+
+        m_segments.reserve(initial_len);
+        m_next_pivots.assign(initial_len, 0u);
+
         for (uint32_t i = 0u; i < initial_len; i++) {
-            Segment segment;
-            auto& entity = segment.entity;
+            Entity entity;
 
             entity.position = {
                 start_pos.x,
                 start_pos.y + i * snek::TILE_SIZE};
+            entity.previousPosition = entity.position;
             entity.size = {snek::TILE_SIZE, snek::TILE_SIZE};
             entity.direction = Direction::Up;
-            entity.texture = TextureManager::getTexture("res/assets/snake_sprites.png");
-            entity.textureIndex = (i == 0) ? 0u : 1u; // head uses first tile, body second
+            entity.sprite = (i == 0) ? SpriteId::SnakeHead : SpriteId::SnakeBody;
             if (i == 0) {
                 entity.rotationOffsetDegrees = 90.f;
             }
 
-            m_segments.push_back(std::move(segment));
+            m_segments.push_back(std::move(entity));
         }
     }
 
     auto turnLeft() -> void {
-        const auto head_dir = m_segments.front().entity.direction;
+        const auto head_dir = getHeading();
 
         turn(static_cast<Direction>(
             (static_cast<int32_t>(head_dir) + 3) % 4
@@ -65,117 +96,420 @@ public:
     }
 
     auto turnRight() -> void {
-        const auto head_dir = m_segments.front().entity.direction;
+        const auto head_dir = getHeading();
 
         turn(static_cast<Direction>(
             (static_cast<int32_t>(head_dir) + 1) % 4));
     }
 
     auto grow() -> void {
-        const auto& tail = m_segments.back();
+        if (m_movement == Movement::Grid) {
+            // The tail simply stays put on the next cell step
+            m_pending_growth++;
+            m_speed += SNAKE_SPEED_INCREMENT;
 
-        Segment new_segment;
+            return;
+        }
 
-        new_segment.next_pivot = tail.next_pivot;
+        const auto& tail = m_segments.back();
 
-        auto& entity = new_segment.entity;
+        Entity entity;
 
         entity.size = {snek::TILE_SIZE, snek::TILE_SIZE};
-        entity.direction = tail.entity.direction;
-        entity.texture = TextureManager::getTexture("res/assets/snake_sprites.png");
-        entity.textureIndex = 1u;
+        entity.direction = tail.direction;
+        entity.sprite = SpriteId::SnakeBody;
 
-        switch (tail.entity.direction) {
+        switch (tail.direction) {
             case Direction::Up:
                 entity.position = {
-                    tail.entity.position.x,
-                    tail.entity.position.y + snek::TILE_SIZE};
+                    tail.position.x,
+                    tail.position.y + snek::TILE_SIZE};
                 break;
             case Direction::Right:
                 entity.position = {
-                    tail.entity.position.x - snek::TILE_SIZE,
-                    tail.entity.position.y};
+                    tail.position.x - snek::TILE_SIZE,
+                    tail.position.y};
                 break;
             case Direction::Down:
                 entity.position = {
-                    tail.entity.position.x,
-                    tail.entity.position.y - snek::TILE_SIZE};
+                    tail.position.x,
+                    tail.position.y - snek::TILE_SIZE};
                 break;
             case Direction::Left:
                 entity.position = {
-                    tail.entity.position.x + snek::TILE_SIZE,
-                    tail.entity.position.y};
+                    tail.position.x + snek::TILE_SIZE,
+                    tail.position.y};
                 break;
         }
 
-        m_segments.push_back(std::move(new_segment));
+        entity.previousPosition = entity.position;
+
+        m_segments.push_back(std::move(entity));
+        m_next_pivots.push_back(m_next_pivots.back());
 
         m_speed += SNAKE_SPEED_INCREMENT;
     }
 
-    auto getEntities() const -> std::vector<const Entity*> {
-        std::vector<const Entity*> entities;
+    auto getMovement() const -> Movement {
+        return m_movement;
+    }
+
+    auto getLength() const -> size_t {
+        return m_movement == Movement::Grid ? m_cells.size() : m_segments.size();
+    }
 
-        entities.reserve(m_segments.size());
+    /**
+     * @brief In pixels per second.
+     */
+    auto getSpeed() const -> float {
+        return m_speed;
+    }
 
-        for (const auto& segment : m_segments) {
-            entities.push_back(&segment.entity);
+    auto getHeading() const -> Direction {
+        return m_movement == Movement::Grid ? m_heading : m_segments.front().direction;
+    }
+
+    /**
+     * @brief Body cells of a grid-mode snake, head first. Empty in free mode.
+     */
+    auto getCells() const -> const CellRing& {
+        return m_cells;
+    }
+
+    auto getHead() const -> const Entity& {
+        return getEntity(0u);
+    }
+
+    /**
+     * @brief Where the head is drawn, without materializing the grid-mode entities.
+     */
+    auto getHeadPosition() const -> sf::Vector2f {
+        return m_movement == Movement::Grid ? gridPosition(0u, m_cell_progress) : m_segments.front().position;
+    }
+
+    auto getEntity(size_t index) const -> const Entity& {
+        if (m_movement == Movement::Grid) {
+            refreshGridEntities();
+
+            return m_grid_entities[index];
+        }
+
+        return m_segments[index];
+    }
+
+    /**
+     * @brief Every segment, head first, as a view into the snake's own contiguous storage.
+     *
+     * Valid until the snake moves, turns or grows. Allocates nothing, except that a
+     * grid-mode snake materializes its segment entities on first access after a step.
+     */
+    auto getEntities() const -> std::span<const Entity> {
+        if (m_movement == Movement::Grid) {
+            refreshGridEntities();
+
+            return m_grid_entities;
         }
 
-        return entities;
+        return m_segments;
+    }
+
+    /**
+     * @brief Whether a turn would be taken right now.
+     *
+     * A free-mode snake travels a tile between turns. A grid-mode one turns at most once
+     * per cell step, its heading only counts at the step, so it can turn in consecutive
+     * cells but never reverse into itself.
+     */
+    auto canTurn() const -> bool {
+        if (m_movement == Movement::Grid) {
+            return !m_turned_this_step;
+        }
+
+        return m_distance_since_last_turn >= snek::TILE_SIZE;
     }
 
     auto turn(Direction new_direction) -> void {
-        if (m_distance_since_last_turn < snek::TILE_SIZE) {
+        if (!canTurn()) {
             return;
         }
         m_distance_since_last_turn = 0.f;
 
-        auto& head = m_segments.front().entity;
+        if (m_movement == Movement::Grid) {
+            // Takes effect on the next cell step
+            m_heading = new_direction;
+            m_turned_this_step = true;
+            m_grid_entities_dirty = true;
+
+            return;
+        }
+
+        auto& head = m_segments.front();
         head.direction = new_direction;
 
-        auto pivot = std::make_shared<Pivot>();
-        pivot->position = head.position;
-        pivot->direction = head.direction;
+        // Segments with no pending pivot point at m_pivot_end already, so appending
+        // the pivot is all it takes to route them through it
+        pushPivot({head.position, head.direction});
+        m_next_pivots.front() = m_pivot_end; // the head itself never follows one
+    }
 
-        for (auto& segment : m_segments | std::views::drop(1)) {
-            if (segment.next_pivot == nullptr) {
-                segment.next_pivot = pivot;
-            } else {
-                segment.next_pivot->next = pivot;
-                break;
-            }
+    /**
+     * @brief Writes everything the snake's future depends on, the cached grid entities aside.
+     */
+    auto saveState(StateWriter& writer) const -> void {
+        writer.put(m_movement);
+        writer.put(m_speed);
+        writer.put(m_distance_since_last_turn);
+
+        if (m_movement == Movement::Grid) {
+            m_cells.saveState(writer);
+            writer.put(m_heading);
+            writer.put(m_cell_progress);
+            writer.put(m_turned_this_step);
+            writer.put(m_last_step_cells);
+            writer.put(m_pending_growth);
+
+            return;
+        }
+
+        writer.putArray<Entity>(m_segments);
+        writer.putArray<uint32_t>(m_next_pivots);
+        writer.putArray<Pivot>(m_pivots);
+        writer.put(m_pivot_begin);
+        writer.put(m_pivot_end);
+    }
+
+    /**
+     * @brief Reads saveState() into this snake, reusing its storage.
+     *
+     * @return false when the state is of a snake of the other movement or inconsistent,
+     *         the snake must not be used then.
+     */
+    auto restoreState(StateReader& reader) -> bool {
+        Movement movement{};
+        if (!reader.get(movement) || movement != m_movement) {
+            return false;
+        }
+
+        reader.get(m_speed);
+        reader.get(m_distance_since_last_turn);
+        m_grid_entities_dirty = true;
+
+        if (m_movement == Movement::Grid) {
+            const bool cells = m_cells.restoreState(reader);
+
+            reader.get(m_heading);
+            reader.get(m_cell_progress);
+            reader.get(m_turned_this_step);
+            reader.get(m_last_step_cells);
+            reader.get(m_pending_growth);
+
+            return cells && !m_cells.empty() && !reader.failed();
+        }
+
+        reader.getArray(m_segments);
+        reader.getArray(m_next_pivots);
+        reader.getArray(m_pivots);
+        reader.get(m_pivot_begin);
+        reader.get(m_pivot_end);
+
+        if (reader.failed() || m_segments.empty() || m_next_pivots.size() != m_segments.size()) {
+            return false;
         }
+
+        m_pivot_mask = m_pivots.empty() ? 0u : static_cast<uint32_t>(m_pivots.size() - 1u);
+
+        // Every pivot still ahead of a segment must be live, the ring is indexed by them
+        const uint32_t live = m_pivot_end - m_pivot_begin;
+        const bool ring_valid = m_pivots.empty() ? live == 0u : std::has_single_bit(m_pivots.size()) && live <= m_pivots.size();
+
+        return ring_valid && std::ranges::all_of(m_next_pivots, [&](uint32_t seq) {
+            return seq - m_pivot_begin <= live;
+        });
     }
 
-    auto move() -> void {
-        m_distance_since_last_turn += m_speed;
+    /**
+     * @brief Advances the snake by one simulation step.
+     *
+     * @param dt Step duration in seconds, the speed is expressed per second.
+     */
+    auto move(float dt) -> void {
+        SNEK_PROFILE_SCOPE("Snake::move");
+
+        const float step = m_speed * dt;
+
+        m_distance_since_last_turn += step;
+
+        if (m_movement == Movement::Grid) {
+            m_last_step_cells = step / snek::TILE_SIZE;
+            m_cell_progress += m_last_step_cells;
+
+            while (m_cell_progress >= 1.f) {
+                m_cell_progress -= 1.f;
+                stepCell();
+            }
+
+            m_grid_entities_dirty = true;
+
+            return;
+        }
+
+        // The head steers, it never follows a pivot
+        auto& head = m_segments.front();
+        head.previousPosition = head.position;
+        move(head, step);
 
-        for (auto& segment : m_segments) {
-            if (segment.next_pivot == nullptr) {
-                move(segment, m_speed);
-            } else {
-                const auto dist = distanceToNextPivot(segment);
+        for (size_t i = 1u; i < m_segments.size(); i++) {
+            auto& segment = m_segments[i];
+            auto& next_pivot = m_next_pivots[i];
 
-                if (dist > m_speed) {
-                    move(segment, m_speed);
-                } else {
-                    segment.entity.position = segment.next_pivot->position;
-                    segment.entity.direction = segment.next_pivot->direction;
+            segment.previousPosition = segment.position;
 
-                    move(segment, m_speed - dist);
+            // At high speeds a single step may carry a segment through several pivots
+            float remaining = step;
 
-                    segment.next_pivot = segment.next_pivot->next;
+            while (next_pivot != m_pivot_end) {
+                const auto& pivot = pivotAt(next_pivot);
+                const auto dist = distanceToPivot(segment, pivot);
+
+                if (dist > remaining) {
+                    break;
                 }
+
+                segment.position = pivot.position;
+                segment.direction = pivot.direction;
+                next_pivot++;
+
+                remaining -= dist;
             }
+
+            move(segment, remaining);
         }
+
+        // The tail is the last one through every pivot, whatever lies before its next one
+        // is not referenced anymore and is retired in bulk
+        m_pivot_begin = m_next_pivots.back();
+    }
+
+    /**
+     * @brief Grid mode: enters the next cell with the head and releases the tail cell.
+     */
+    auto stepCell() -> void {
+        const auto& head = m_cells.at(m_cells.getHeadSeq());
+
+        m_cells.pushHead({head.position + cellOffset(m_heading), m_heading});
+        m_turned_this_step = false;
+
+        if (m_pending_growth > 0u) {
+            m_pending_growth--;
+        } else {
+            m_cells.popTail();
+        }
+    }
+
+    static auto cellOffset(Direction direction) -> sf::Vector2i {
+        switch (direction) {
+            case Direction::Up:    return {0, -1};
+            case Direction::Right: return {1, 0};
+            case Direction::Down:  return {0, 1};
+            case Direction::Left:  return {-1, 0};
+        }
+
+        return {0, 0};
+    }
+
+    static auto cellCenter(sf::Vector2i cell) -> sf::Vector2f {
+        return {
+            cell.x * snek::TILE_SIZE + snek::TILE_SIZE / 2.f,
+            cell.y * snek::TILE_SIZE + snek::TILE_SIZE / 2.f
+        };
+    }
+
+    /**
+     * @brief Grid mode: render position of the index-th segment, progress of the way toward
+     * the cell ahead of it. Negative progress looks back in time, into the cells behind.
+     */
+    auto gridPosition(uint32_t index, float progress) const -> sf::Vector2f {
+        while (progress < 0.f) {
+            index++;
+            progress += 1.f;
+        }
+
+        if (index >= m_cells.size()) {
+            return cellCenter(m_cells.fromHead(m_cells.size() - 1u).position);
+        }
+
+        const auto& cell = m_cells.fromHead(index);
+        const auto ahead = index == 0u
+            ? cell.position + cellOffset(m_heading)
+            : m_cells.fromHead(index - 1u).position;
+
+        const auto from = cellCenter(cell.position);
+        const auto to = cellCenter(ahead);
+
+        return from + (to - from) * progress;
+    }
+
+    /**
+     * @brief Grid mode: materializes segment entities from the cell ring, only when asked for.
+     */
+    auto refreshGridEntities() const -> void {
+        if (!m_grid_entities_dirty) {
+            return;
+        }
+
+        const uint32_t length = m_cells.size();
+        m_grid_entities.resize(length);
+
+        for (uint32_t i = 0u; i < length; i++) {
+            auto& entity = m_grid_entities[i];
+
+            entity.position = gridPosition(i, m_cell_progress);
+            entity.previousPosition = gridPosition(i, m_cell_progress - m_last_step_cells);
+            entity.size = {snek::TILE_SIZE, snek::TILE_SIZE};
+            entity.direction = i == 0u ? m_heading : m_cells.fromHead(i - 1u).direction;
+            entity.sprite = (i == 0u) ? SpriteId::SnakeHead : SpriteId::SnakeBody;
+            entity.rotationOffsetDegrees = (i == 0u) ? 90.f : 0.f;
+        }
+
+        m_grid_entities_dirty = false;
+    }
+
+    auto pivotAt(uint32_t seq) const -> const Pivot& {
+        return m_pivots[seq & m_pivot_mask];
+    }
+
+    auto pushPivot(const Pivot& pivot) -> void {
+        if (m_pivot_end - m_pivot_begin == m_pivots.size()) {
+            growPivots();
+        }
+
+        m_pivots[m_pivot_end & m_pivot_mask] = pivot;
+        m_pivot_end++;
+    }
+
+    /**
+     * @brief Doubles the ring, only needed when more turns are live than it can hold.
+     *
+     * Live pivots are bounded by the snake length (turns are at least a tile apart),
+     * so this is amortized over growth, never paid per turn.
+     */
+    auto growPivots() -> void {
+        std::vector<Pivot> pivots(std::max<size_t>(m_pivots.size() * 2u, 16u));
+        const auto mask = static_cast<uint32_t>(pivots.size() - 1u);
+
+        for (uint32_t seq = m_pivot_begin; seq != m_pivot_end; seq++) {
+            pivots[seq & mask] = pivotAt(seq);
+        }
+
+        m_pivots = std::move(pivots);
+        m_pivot_mask = mask;
     }
 
-    auto distanceToNextPivot(const Segment& segment) const -> float {
-        const auto& pivot_pos = segment.next_pivot->position;
-        const auto& seg_pos = segment.entity.position;
+    auto distanceToPivot(const Entity& segment, const Pivot& pivot) const -> float {
+        const auto& pivot_pos = pivot.position;
+        const auto& seg_pos = segment.position;
 
-        switch (segment.entity.direction) {
+        switch (segment.direction) {
             case Direction::Up:
                 return seg_pos.y - pivot_pos.y;
             case Direction::Right:
@@ -189,25 +523,47 @@ public:
         return 0.f;
     }
 
-    auto move(Segment& segment, float amount) -> void {
-        switch (segment.entity.direction) {
+    auto move(Entity& segment, float amount) -> void {
+        switch (segment.direction) {
             case Direction::Up:
-                segment.entity.position.y -= amount;
+                segment.position.y -= amount;
                 break;
             case Direction::Right:
-                segment.entity.position.x += amount;
+                segment.position.x += amount;
                 break;
             case Direction::Down:
-                segment.entity.position.y += amount;
+                segment.position.y += amount;
                 break;
             case Direction::Left:
-                segment.entity.position.x -= amount;
+                segment.position.x -= amount;
                 break;
         }
     }
 
-    std::vector<Segment> m_segments;
-    float m_speed{SNAKE_INITIAL_SPEED};
+    Movement m_movement;
+
+    // Free mode segments, head first. Entities stay contiguous so they can be handed
+    // out as a span, the pivot bookkeeping lives beside them.
+    std::vector<Entity> m_segments;
+    std::vector<uint32_t> m_next_pivots; // seq of each segment's next pivot, m_pivot_end when none
+    float m_speed{SNAKE_INITIAL_SPEED}; // pixels per second
+
+    // Pivot ring buffer, live pivots are the sequence numbers [m_pivot_begin, m_pivot_end)
+    std::vector<Pivot> m_pivots;
+    uint32_t m_pivot_mask{0u};
+    uint32_t m_pivot_begin{0u};
+    uint32_t m_pivot_end{0u};
+
+    // Grid mode state
+    CellRing m_cells;
+    Direction m_heading{Direction::Up};
+    float m_cell_progress{0.f}; // fraction of the way into the next cell
+    bool m_turned_this_step{false}; // one turn between cell steps at most
+    float m_last_step_cells{0.f};
+    uint32_t m_pending_growth{0u};
+
+    mutable std::vector<Entity> m_grid_entities;
+    mutable bool m_grid_entities_dirty{true};
 
     float m_distance_since_last_turn{0.f};
 }; // class Snake
@@ -1,72 +1,194 @@
 /**
  * @file SoundSystem.hpp
- * 
- * @brief Sound system for the snek game.
+ *
+ * @brief Sound system for the snek game, safe to call from any thread.
+ *
+ * Every sound is decoded once by Preload() at startup, from the asset pack when mounted.
+ * Playing picks one of a fixed set of voices, stealing the least important one when all
+ * are busy, so Play() never touches the disk or the heap.
  */
 #pragma once
 
 #include <SFML/Audio.hpp>
 
-#include <vector>
-#include <string>
-#include <unordered_map>
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <print>
+
+#include "snek/AssetPack.hpp"
+#include "snek/Assets.hpp"
+#include "snek/Profiler.hpp"
 
 namespace snek {
 
 class SoundSystem {
 public:
-    static auto Play(std::string_view sound_path) -> void {
+    static constexpr size_t VOICE_COUNT = 16u;
+
+    /**
+     * @brief Decodes every sound of the bank, call once at startup, from any thread.
+     *
+     * Decoding doesn't hold the lock, Play() keeps working (silently) until it's done.
+     *
+     * @return false if some sound failed to load, it then stays silent.
+     */
+    static auto Preload() -> bool {
+        std::array<std::optional<sf::SoundBuffer>, SOUND_COUNT> buffers;
+        bool all_loaded = true;
+
+        for (size_t i = 0u; i < SOUND_COUNT; i++) {
+            auto& buffer = buffers[i];
+
+            buffer.emplace();
+            const auto path = assetPath(static_cast<SoundId>(i));
+            if (!loadAsset(*buffer, path)) {
+                std::println(stderr, "Failed to load sound: {}", path);
+
+                buffer.reset();
+                all_loaded = false;
+            }
+        }
+
         auto& instance = get_instance();
+        std::lock_guard lock{instance.m_mutex};
 
-        const auto& buffer = instance.loadOrGetBuffer(sound_path);
+        // Only fill empty slots, voices may already be playing the loaded ones
+        for (size_t i = 0u; i < SOUND_COUNT; i++) {
+            if (!instance.m_buffers[i] && buffers[i]) {
+                instance.m_buffers[i] = std::move(buffers[i]);
+            }
+        }
 
-        auto& m_sounds = instance.m_sounds;
-        m_sounds.erase(
-            std::remove_if(
-                m_sounds.begin(),
-                m_sounds.end(),
-                [](const sf::Sound& sound) {
-                    return sound.getStatus() == sf::Sound::Status::Stopped;
-                }
-            ),
-            m_sounds.end()
-        );
+        return all_loaded;
+    }
+
+    static auto Play(SoundId id) -> void {
+        SNEK_PROFILE_SCOPE("SoundSystem::Play");
+
+        auto& instance = get_instance();
+        std::lock_guard lock{instance.m_mutex};
+
+        const auto& buffer = instance.m_buffers[static_cast<size_t>(id)];
+        if (!buffer) {
+            return; // not preloaded or failed to load
+        }
+
+        auto* voice = instance.pickVoice(id);
+        if (voice == nullptr) {
+            return; // every voice plays something more important
+        }
 
-        m_sounds.emplace_back(buffer);
-        m_sounds.back().setVolume(instance.m_volume);
-        m_sounds.back().play();
+        if (!voice->sound) {
+            voice->sound.emplace(*buffer);
+        } else {
+            voice->sound->setBuffer(*buffer);
+        }
+
+        voice->id = id;
+        voice->startedAt = instance.m_play_counter++;
+
+        voice->sound->setVolume(instance.m_volume);
+        voice->sound->play();
     }
 
     static auto SetVolume(float volume) -> void {
         auto& instance = get_instance();
+        std::lock_guard lock{instance.m_mutex};
+
         instance.m_volume = volume;
 
-        for (auto& sound : instance.m_sounds) {
-            sound.setVolume(volume);
+        for (auto& voice : instance.m_voices) {
+            if (voice.sound) {
+                voice.sound->setVolume(volume);
+            }
         }
     }
 private:
-    float m_volume{60.f};
-    std::vector<sf::Sound> m_sounds;
-    std::unordered_map<std::string_view, sf::SoundBuffer> m_sound_buffers;
-
-    auto loadOrGetBuffer(std::string_view sound_path) -> const sf::SoundBuffer& {
-        const auto it = m_sound_buffers.find(sound_path);
+    static constexpr size_t SOUND_COUNT = static_cast<size_t>(SoundId::Count);
+
+    struct SoundInfo {
+        uint8_t priority;  // a sound may only steal voices of equal or lower priority
+        uint8_t maxVoices; // beyond this the sound restarts its own oldest voice
+    };
+
+    // Playback rules, indexed by SoundId like the asset table the paths come from
+    static constexpr std::array<SoundInfo, SOUND_COUNT> BANK = {{
+        {1u, 2u}, // MenuOption
+        {1u, 2u}, // MenuConfirm
+        {0u, 4u}, // Turn
+        {2u, 4u}, // Eat
+        {3u, 1u}, // Death
+    }};
+
+    struct Voice {
+        std::optional<sf::Sound> sound; // sf::Sound needs a buffer up front
+        SoundId id{SoundId::Count};
+        uint64_t startedAt{0u};
+
+        auto playing() const -> bool {
+            return sound && sound->getStatus() != sf::Sound::Status::Stopped;
+        }
+    };
+
+    /**
+     * @brief Free voice if any, else the one to steal, nullptr when nothing may be stolen.
+     *
+     * One pass over the fixed voice array. A sound at its voice limit reuses its own oldest
+     * voice, otherwise the lowest priority, oldest voice goes if it's not above the new sound.
+     */
+    auto pickVoice(SoundId id) -> Voice* {
+        const auto& info = BANK[static_cast<size_t>(id)];
+
+        Voice* free_voice = nullptr;
+        Voice* own_oldest = nullptr;
+        Voice* victim = nullptr;
+        uint32_t own_count = 0u;
+
+        for (auto& voice : m_voices) {
+            if (!voice.playing()) {
+                free_voice = free_voice ? free_voice : &voice;
+                continue;
+            }
+
+            if (voice.id == id) {
+                own_count++;
+                if (own_oldest == nullptr || voice.startedAt < own_oldest->startedAt) {
+                    own_oldest = &voice;
+                }
+            }
+
+            const auto priority = BANK[static_cast<size_t>(voice.id)].priority;
+            if (victim == nullptr ||
+                priority < BANK[static_cast<size_t>(victim->id)].priority ||
+                (priority == BANK[static_cast<size_t>(victim->id)].priority && voice.startedAt < victim->startedAt)) {
+                victim = &voice;
+            }
+        }
 
-        if (it != m_sound_buffers.end()) {
-            return it->second;
+        if (own_count >= info.maxVoices) {
+            return own_oldest;
         }
 
-        sf::SoundBuffer buffer;
-        if (!buffer.loadFromFile(sound_path)) {
-            throw std::runtime_error("Failed to load sound: " + std::string(sound_path));
+        if (free_voice != nullptr) {
+            return free_voice;
         }
 
-        m_sound_buffers.emplace(sound_path, std::move(buffer));
+        if (victim != nullptr && BANK[static_cast<size_t>(victim->id)].priority <= info.priority) {
+            return victim;
+        }
 
-        return m_sound_buffers.at(sound_path);
+        return nullptr;
     }
 
+    std::mutex m_mutex;
+    float m_volume{60.f};
+    uint64_t m_play_counter{0u};
+
+    std::array<std::optional<sf::SoundBuffer>, SOUND_COUNT> m_buffers;
+    std::array<Voice, VOICE_COUNT> m_voices;
+
     static auto get_instance() -> SoundSystem& {
         static SoundSystem instance;
         return instance;
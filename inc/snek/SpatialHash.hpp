@@ -0,0 +1,175 @@
+/**
+ * @file SpatialHash.hpp
+ *
+ * @brief Snake segments of every snake on the board hashed by the cell they're in, for the
+ * broadphase between snakes.
+ *
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace snek {
+
+/**
+ * @brief Chained hash of body segments keyed by OccupancyGrid cell id.
+ *
+ * Sized for the segments of the board, not the board itself, so it stays small on huge
+ * sparse arenas. Entries keep their id until removed, so the board updates the hash as
+ * the snakes move instead of rebuilding it, and removed slots are reused, so a board whose
+ * snakes stop growing doesn't allocate anymore. Reads are safe from many threads as long
+ * as nothing is changed meanwhile.
+ */
+class SpatialHash {
+public:
+    struct Entry {
+        uint32_t cell;    // NONE while the slot is free
+        uint32_t snake;   // 0 is the player, arena snake i is i + 1
+        uint32_t segment; // free mode: index from the head, grid mode: CellRing seq of the cell
+        uint32_t next;    // next entry of the bucket, or of the free slots, NONE at the end
+        sf::Vector2f position;
+    };
+
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    /**
+     * @brief Empties the hash, growing the buckets to about twice the segments expected.
+     */
+    auto clear(size_t expected_segments) -> void {
+        m_entries.clear();
+        m_free = NONE;
+        m_size = 0u;
+
+        resize(expected_segments);
+    }
+
+    /**
+     * @return Id of the entry, valid until it's removed.
+     */
+    auto insert(uint32_t cell, uint32_t snake, uint32_t segment, sf::Vector2f position) -> uint32_t {
+        if ((m_size + 1u) * 2u > m_buckets.size()) {
+            resize(m_size + 1u);
+        }
+
+        uint32_t id = m_free;
+        if (id == NONE) {
+            id = static_cast<uint32_t>(m_entries.size());
+            m_entries.emplace_back();
+        } else {
+            m_free = m_entries[id].next;
+        }
+
+        m_entries[id] = {cell, snake, segment, NONE, position};
+        link(id);
+        m_size++;
+
+        return id;
+    }
+
+    auto remove(uint32_t id) -> void {
+        unlink(id);
+
+        m_entries[id].cell = NONE;
+        m_entries[id].next = m_free;
+        m_free = id;
+        m_size--;
+    }
+
+    /**
+     * @brief Moves an entry to another position, relinking it only when the cell changes.
+     */
+    auto move(uint32_t id, uint32_t cell, sf::Vector2f position) -> void {
+        auto& entry = m_entries[id];
+        entry.position = position;
+
+        if (entry.cell != cell) {
+            unlink(id);
+            entry.cell = cell;
+            link(id);
+        }
+    }
+
+    /**
+     * @brief Calls fn(entry) for every segment in the cell.
+     */
+    template<typename Fn>
+    auto forEachIn(uint32_t cell, Fn&& fn) const -> void {
+        if (m_buckets.empty()) {
+            return;
+        }
+
+        for (auto index = m_buckets[bucketOf(cell)]; index != NONE; index = m_entries[index].next) {
+            if (m_entries[index].cell == cell) {
+                fn(m_entries[index]);
+            }
+        }
+    }
+
+    auto contains(uint32_t cell) const -> bool {
+        bool found = false;
+
+        forEachIn(cell, [&](const Entry&) { found = true; });
+
+        return found;
+    }
+
+    auto size() const -> size_t {
+        return m_size;
+    }
+private:
+    auto bucketOf(uint32_t cell) const -> uint32_t {
+        // Fibonacci hashing, neighbouring cells land far apart
+        return (cell * 0x9E3779B1u) >> m_shift;
+    }
+
+    auto link(uint32_t id) -> void {
+        auto& bucket = m_buckets[bucketOf(m_entries[id].cell)];
+
+        m_entries[id].next = bucket;
+        bucket = id;
+    }
+
+    auto unlink(uint32_t id) -> void {
+        auto* slot = &m_buckets[bucketOf(m_entries[id].cell)];
+
+        while (*slot != id) {
+            slot = &m_entries[*slot].next;
+        }
+
+        *slot = m_entries[id].next;
+    }
+
+    /**
+     * @brief Grows the buckets to about twice the segments expected and relinks the live entries.
+     */
+    auto resize(size_t expected_segments) -> void {
+        const auto wanted = std::bit_ceil(std::max<size_t>(expected_segments * 2u, 64u));
+
+        if (wanted > m_buckets.size()) {
+            m_buckets.resize(wanted);
+            m_shift = static_cast<uint32_t>(32 - std::countr_zero(wanted));
+        }
+
+        std::ranges::fill(m_buckets, NONE);
+
+        for (uint32_t id = 0u; id < m_entries.size(); id++) {
+            if (m_entries[id].cell != NONE) {
+                link(id);
+            }
+        }
+    }
+
+    std::vector<uint32_t> m_buckets;
+    std::vector<Entry> m_entries;
+    uint32_t m_free{NONE}; // first free slot, chained through next
+    uint32_t m_size{0u};
+    uint32_t m_shift{32u};
+}; // class SpatialHash
+
+} // namespace snek
@@ -0,0 +1,144 @@
+/**
+ * @file StateStream.hpp
+ *
+ * @brief Flat writer and reader of in-memory simulation state, plain memcpy of trivially copyable data.
+ *
+ * Unlike ByteStream the bytes are in the build's native layout and byte order, a state
+ * is read back by the same build only. Arrays are a u32 count followed by the elements.
+ *
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace snek {
+
+/**
+ * @brief Appends to a caller-owned buffer, which keeps its capacity across saves.
+ */
+class StateWriter {
+public:
+    explicit StateWriter(std::vector<uint8_t>& out)
+        : m_out(out)
+    {}
+
+    template<typename T>
+    auto put(const T& value) -> void {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+        m_out.insert(m_out.end(), bytes, bytes + sizeof(T));
+    }
+
+    template<typename T>
+    auto putArray(std::span<const T> values) -> void {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        put(static_cast<uint32_t>(values.size()));
+
+        const auto* bytes = reinterpret_cast<const uint8_t*>(values.data());
+        m_out.insert(m_out.end(), bytes, bytes + values.size_bytes());
+    }
+
+    auto putBytes(std::span<const uint8_t> bytes) -> void {
+        m_out.insert(m_out.end(), bytes.begin(), bytes.end());
+    }
+
+    auto size() const -> size_t {
+        return m_out.size();
+    }
+
+    /**
+     * @brief Overwrites a value put earlier at the given offset, for sizes known only at the end.
+     */
+    template<typename T>
+    auto patch(size_t offset, const T& value) -> void {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        std::memcpy(m_out.data() + offset, &value, sizeof(T));
+    }
+private:
+    std::vector<uint8_t>& m_out;
+}; // class StateWriter
+
+/**
+ * @brief Reads what StateWriter wrote. Reads past the end fail and mark the reader failed.
+ */
+class StateReader {
+public:
+    explicit StateReader(std::span<const uint8_t> bytes)
+        : m_bytes(bytes)
+    {}
+
+    template<typename T>
+    auto get(T& value) -> bool {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        if (m_failed || remaining() < sizeof(T)) {
+            m_failed = true;
+
+            return false;
+        }
+
+        std::memcpy(&value, m_bytes.data() + m_pos, sizeof(T));
+        m_pos += sizeof(T);
+
+        return true;
+    }
+
+    /**
+     * @brief Replaces the vector's contents, its capacity is reused.
+     */
+    template<typename T>
+    auto getArray(std::vector<T>& values) -> bool {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        uint32_t count = 0u;
+        if (!get(count) || count > remaining() / sizeof(T)) {
+            m_failed = true;
+
+            return false;
+        }
+
+        values.resize(count);
+        std::memcpy(values.data(), m_bytes.data() + m_pos, count * sizeof(T));
+        m_pos += count * sizeof(T);
+
+        return true;
+    }
+
+    /**
+     * @brief The next count bytes as they are, an empty span when there aren't as many.
+     */
+    auto getBytes(size_t count) -> std::span<const uint8_t> {
+        if (m_failed || remaining() < count) {
+            m_failed = true;
+
+            return {};
+        }
+
+        const auto bytes = m_bytes.subspan(m_pos, count);
+        m_pos += count;
+
+        return bytes;
+    }
+
+    auto remaining() const -> size_t {
+        return m_bytes.size() - m_pos;
+    }
+
+    auto failed() const -> bool {
+        return m_failed;
+    }
+private:
+    std::span<const uint8_t> m_bytes;
+    size_t m_pos{0u};
+    bool m_failed{false};
+}; // class StateReader
+
+} // namespace snek
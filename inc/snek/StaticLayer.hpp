@@ -0,0 +1,223 @@
+/**
+ * @file StaticLayer.hpp
+ *
+ * @brief Floor and rocks of a level baked into GPU vertex buffers once, drawn with a draw call or two per frame.
+ *
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/VertexBuffer.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <print>
+#include <vector>
+
+#include "snek/Assets.hpp"
+#include "snek/Board.hpp"
+#include "snek/constants.hpp"
+#include "snek/EntityChunks.hpp"
+#include "snek/Profiler.hpp"
+#include "snek/Renderer.hpp"
+#include "snek/TextureManager.hpp"
+
+namespace snek {
+
+/**
+ * @brief Everything of a board that only changes with the level, rebuilt when the level does.
+ *
+ * The floor is a single quad over the whole board with a repeated checkerboard texture.
+ * Rock quads are sorted by entity chunk, row by row, so the chunks a view touches form at
+ * most one vertex range per chunk row, and a single one when the view spans the board's
+ * width. The draw cost doesn't depend on how many rocks there are.
+ */
+class StaticLayer {
+public:
+    auto isBuiltFor(const Board& board) const -> bool {
+        return isBuiltFor(board.getLevelId());
+    }
+
+    auto isBuiltFor(uint64_t level_id) const -> bool {
+        return m_level_id == level_id;
+    }
+
+    /**
+     * @brief Bakes the board's floor and rocks, needs the window's GL context.
+     */
+    auto build(const Board& board) -> void {
+        build(board.getLevelId(), board.getWidth(), board.getHeight(), board.getRocks());
+    }
+
+    /**
+     * @brief Same for a level known by its parts only, e.g. one a server sent. Level ids start at 1.
+     */
+    auto build(uint64_t level_id, uint32_t width, uint32_t height, const EntityChunks& rocks) -> void {
+        SNEK_PROFILE_SCOPE("StaticLayer::build");
+
+        m_level_id = level_id;
+        m_chunks_x = (width + ENTITY_CHUNK_TILES - 1u) / ENTITY_CHUNK_TILES;
+        m_chunks_y = (height + ENTITY_CHUNK_TILES - 1u) / ENTITY_CHUNK_TILES;
+
+        buildFloor(width, height);
+        buildRocks(rocks);
+    }
+
+    /**
+     * @brief Draws the floor and the rocks of the chunks the area touches, in board pixels.
+     */
+    auto draw(Renderer& renderer, const sf::FloatRect& area) const -> void {
+        if (m_floor_texture) {
+            drawRange(renderer, m_floor, m_floor_fallback, 0u, FLOOR_VERTICES, &*m_floor_texture);
+        }
+
+        const auto* atlas = TextureManager::getTexture(TextureId::Atlas);
+        if (atlas == nullptr || m_rock_offsets.empty()) {
+            return;
+        }
+
+        const auto first = chunkCoords(area.position - sf::Vector2f{TILE_SIZE, TILE_SIZE});
+        const auto last = chunkCoords(area.position + area.size + sf::Vector2f{TILE_SIZE, TILE_SIZE});
+
+        // Consecutive rows merge into one range when the view spans every column
+        uint32_t range_begin = 0u;
+        uint32_t range_end = 0u;
+
+        for (uint32_t y = first.y; y <= last.y; y++) {
+            const uint32_t begin = m_rock_offsets[y * m_chunks_x + first.x];
+            const uint32_t end = m_rock_offsets[y * m_chunks_x + last.x + 1u];
+
+            if (begin != range_end) {
+                drawRange(renderer, m_rocks, m_rocks_fallback, range_begin, range_end - range_begin, atlas);
+                range_begin = begin;
+            }
+
+            range_end = end;
+        }
+
+        drawRange(renderer, m_rocks, m_rocks_fallback, range_begin, range_end - range_begin, atlas);
+    }
+private:
+    static constexpr uint32_t FLOOR_VERTICES = 6u;
+    static constexpr uint32_t QUAD_VERTICES = 6u;
+
+    auto buildFloor(uint32_t width, uint32_t height) -> void {
+        // One texel per tile, nearest filtering and repeat turn it into a checkerboard
+        sf::Image image{{2u, 2u}, sf::Color{FLOOR_COLOR_LIGHT}};
+        image.setPixel({1u, 0u}, sf::Color{FLOOR_COLOR_DARK});
+        image.setPixel({0u, 1u}, sf::Color{FLOOR_COLOR_DARK});
+
+        m_floor_texture.emplace();
+        if (!m_floor_texture->loadFromImage(image)) {
+            std::println(stderr, "Failed to create the floor texture");
+            m_floor_texture.reset();
+
+            return;
+        }
+        m_floor_texture->setRepeated(true);
+
+        const sf::Vector2f tiles{static_cast<float>(width), static_cast<float>(height)};
+        const sf::Vector2f pixels = tiles * TILE_SIZE;
+
+        const std::array<sf::Vertex, FLOOR_VERTICES> floor = {{
+            {{0.f,      0.f},      sf::Color::White, {0.f,     0.f}},
+            {{pixels.x, 0.f},      sf::Color::White, {tiles.x, 0.f}},
+            {{pixels.x, pixels.y}, sf::Color::White, {tiles.x, tiles.y}},
+            {{0.f,      0.f},      sf::Color::White, {0.f,     0.f}},
+            {{pixels.x, pixels.y}, sf::Color::White, {tiles.x, tiles.y}},
+            {{0.f,      pixels.y}, sf::Color::White, {0.f,     tiles.y}},
+        }};
+
+        upload(m_floor, m_floor_fallback, {floor.begin(), floor.end()});
+    }
+
+    auto buildRocks(const EntityChunks& rocks) -> void {
+        // Counting sort by chunk, offsets in vertices with one extra entry closing the last chunk
+        m_rock_offsets.assign(static_cast<size_t>(m_chunks_x) * m_chunks_y + 1u, 0u);
+
+        rocks.forEach([&](const Entity& rock) {
+            m_rock_offsets[chunkIndex(rock.position) + 1u] += QUAD_VERTICES;
+        });
+
+        for (size_t i = 1u; i < m_rock_offsets.size(); i++) {
+            m_rock_offsets[i] += m_rock_offsets[i - 1u];
+        }
+
+        std::vector<uint32_t> cursor(m_rock_offsets.begin(), m_rock_offsets.end() - 1);
+        std::vector<sf::Vertex> vertices(m_rock_offsets.back());
+
+        rocks.forEach([&](const Entity& rock) {
+            const auto quad = Renderer::spriteQuad(rock.position, rock.size, Renderer::entityAngle(rock), getSpriteRect(rock.sprite));
+
+            auto& at = cursor[chunkIndex(rock.position)];
+            std::ranges::copy(quad, vertices.begin() + at);
+            at += QUAD_VERTICES;
+        });
+
+        upload(m_rocks, m_rocks_fallback, std::move(vertices));
+    }
+
+    /**
+     * @brief Moves the vertices to the GPU, or keeps them client-side without vertex buffer support.
+     */
+    static auto upload(sf::VertexBuffer& buffer, std::vector<sf::Vertex>& fallback, std::vector<sf::Vertex> vertices) -> void {
+        fallback.clear();
+
+        if (!sf::VertexBuffer::isAvailable() ||
+            !buffer.create(vertices.size()) ||
+            !buffer.update(vertices.data(), vertices.size(), 0u)) {
+            fallback = std::move(vertices);
+        }
+    }
+
+    static auto drawRange(
+        Renderer& renderer,
+        const sf::VertexBuffer& buffer,
+        const std::vector<sf::Vertex>& fallback,
+        uint32_t first,
+        uint32_t count,
+        const sf::Texture* texture
+    ) -> void {
+        if (!fallback.empty()) {
+            renderer.drawVertices(std::span{fallback}.subspan(first, count), texture);
+        } else {
+            renderer.drawVertices(buffer, first, count, texture);
+        }
+    }
+
+    auto chunkCoords(sf::Vector2f position) const -> sf::Vector2u {
+        const auto axis = [](float pixels, uint32_t count) -> uint32_t {
+            if (pixels <= 0.f) {
+                return 0u;
+            }
+
+            return std::min(static_cast<uint32_t>(pixels / EntityChunks::CHUNK_PIXELS), count - 1u);
+        };
+
+        return {axis(position.x, m_chunks_x), axis(position.y, m_chunks_y)};
+    }
+
+    auto chunkIndex(sf::Vector2f position) const -> uint32_t {
+        const auto coords = chunkCoords(position);
+
+        return coords.y * m_chunks_x + coords.x;
+    }
+
+    uint64_t m_level_id{0u}; // board level ids start at 1, nothing is built yet
+    uint32_t m_chunks_x{0u};
+    uint32_t m_chunks_y{0u};
+
+    std::optional<sf::Texture> m_floor_texture;
+    sf::VertexBuffer m_floor{sf::PrimitiveType::Triangles, sf::VertexBuffer::Usage::Static};
+    std::vector<sf::Vertex> m_floor_fallback;
+
+    sf::VertexBuffer m_rocks{sf::PrimitiveType::Triangles, sf::VertexBuffer::Usage::Static};
+    std::vector<sf::Vertex> m_rocks_fallback;
+    std::vector<uint32_t> m_rock_offsets; // per chunk, row-major, first vertex of its rocks
+}; // class StaticLayer
+
+} // namespace snek
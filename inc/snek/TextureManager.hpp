@@ -1,52 +1,99 @@
 /**
  * @file TextureManager.hpp
  * 
- * @brief Simple singleton texture manager to load and cache textures.
+ * @brief Simple singleton texture manager to load and cache textures, safe to call from any thread.
+ *
+ * Textures are addressed by TextureId handles, a lookup is an index into a fixed array.
+ *
+ * Textures come from the mounted asset pack when it has them, loose files otherwise.
  * 
  * @authors Jacek Zub
  */
 #pragma once
 
+#include <SFML/Graphics/Image.hpp>
 #include <SFML/Graphics/Texture.hpp>
 
-#include <string>
-#include <string_view>
-#include <unordered_map>
+#include <array>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <print>
 
+#include "snek/AssetPack.hpp"
+#include "snek/Assets.hpp"
+
 namespace snek {
 
 class TextureManager {
 public:
-    static auto getTexture(std::string_view path) -> const sf::Texture* {
-        auto& textures = instance().m_textures;
+    static auto getTexture(TextureId id) -> const sf::Texture* {
+        auto& slot = instance().m_slots[static_cast<size_t>(id)];
 
-        const auto it = textures.find(std::string{path});
+        std::unique_lock lock{instance().m_mutex};
 
-        if (it != textures.end()) {
-            return it->second.get();
+        if (slot.texture) {
+            return slot.texture.get();
         }
 
         auto texture = std::make_unique<sf::Texture>();
 
-        std::string_view key{path};
+        if (slot.pending.valid()) {
+            // Decoded in the background, only the upload is left. Waits if it's not done yet.
+            auto decoding = std::move(slot.pending);
+
+            lock.unlock();
+            const auto image = decoding.get();
+            lock.lock();
+
+            // Another thread may have loaded it from disk in the meantime
+            if (slot.texture) {
+                return slot.texture.get();
+            }
 
-        if (!texture->loadFromFile(key)) {
-            //std::println(stderr, "Failed to load texture from path: {}", path);
+            if (!image || !texture->loadFromImage(*image)) {
+                return nullptr;
+            }
+        } else if (!loadAsset(*texture, assetPath(id))) {
+            //std::println(stderr, "Failed to load texture from path: {}", assetPath(id));
 
             return nullptr;
         }
 
-        const auto texture_ptr = texture.get();
+        slot.texture = std::move(texture);
+
+        return slot.texture.get();
+    }
+
+    /**
+     * @brief Starts decoding the image on a background thread, getTexture() then only uploads it.
+     */
+    static auto prefetch(TextureId id) -> void {
+        auto& slot = instance().m_slots[static_cast<size_t>(id)];
 
-        textures.emplace(key, std::move(texture));
+        std::lock_guard lock{instance().m_mutex};
 
-        return texture_ptr;
+        if (slot.texture || slot.pending.valid()) {
+            return;
+        }
+
+        slot.pending = std::async(std::launch::async, [id]() -> std::optional<sf::Image> {
+            sf::Image image;
+            if (!loadAsset(image, assetPath(id))) {
+                return std::nullopt;
+            }
+
+            return image;
+        });
     }
 
     static auto unloadAll() -> void {
-        instance().m_textures.clear();
+        std::lock_guard lock{instance().m_mutex};
+
+        for (auto& slot : instance().m_slots) {
+            slot.texture.reset();
+        }
     }
 
 private:
@@ -57,10 +104,13 @@ private:
         return instance;
     }
 
-    std::unordered_map<
-        std::string,
-        std::unique_ptr<sf::Texture>
-    > m_textures;
+    struct Slot {
+        std::unique_ptr<sf::Texture> texture;
+        std::future<std::optional<sf::Image>> pending;
+    };
+
+    std::mutex m_mutex;
+    std::array<Slot, static_cast<size_t>(TextureId::Count)> m_slots; // indexed by TextureId
 }; // class TextureManager
 
 } // namespace snek
@@ -0,0 +1,208 @@
+/**
+ * @file WorkStealingPool.hpp
+ *
+ * @brief Fixed set of worker threads running index ranges, idle workers steal half of a busy one's range.
+ *
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace snek {
+
+class WorkStealingPool {
+public:
+    /**
+     * @param thread_count 0 picks std::thread::hardware_concurrency().
+     */
+    explicit WorkStealingPool(uint32_t thread_count = 0u) {
+        if (thread_count == 0u) {
+            thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+
+        m_queues.reserve(thread_count);
+        for (uint32_t i = 0u; i < thread_count; i++) {
+            m_queues.push_back(std::make_unique<Queue>());
+        }
+
+        // The calling thread works as worker 0, only the others get their own thread
+        m_threads.reserve(thread_count - 1u);
+        for (uint32_t i = 1u; i < thread_count; i++) {
+            m_threads.emplace_back([this, i](std::stop_token stop) { workerLoop(stop, i); });
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard lock{m_mutex};
+            for (auto& thread : m_threads) {
+                thread.request_stop();
+            }
+        }
+
+        m_wake.notify_all();
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    auto operator=(const WorkStealingPool&) -> WorkStealingPool& = delete;
+
+    auto getThreadCount() const -> uint32_t {
+        return static_cast<uint32_t>(m_queues.size());
+    }
+
+    /**
+     * @brief Calls task(index, worker) for every index in [0, count), returns when all are done.
+     *
+     * Each worker starts with an equal contiguous share, a worker that runs dry steals
+     * the upper half of the largest remaining share. Not reentrant.
+     */
+    auto parallelFor(uint64_t count, std::function<void(uint64_t, uint32_t)> task) -> void {
+        const auto workers = static_cast<uint64_t>(m_queues.size());
+
+        for (uint64_t i = 0u; i < workers; i++) {
+            auto& queue = *m_queues[i];
+
+            std::lock_guard lock{queue.mutex};
+            queue.begin = count * i / workers;
+            queue.end = count * (i + 1u) / workers;
+        }
+
+        {
+            std::lock_guard lock{m_mutex};
+            m_task = std::move(task);
+            m_running = static_cast<uint32_t>(workers);
+            m_generation++;
+        }
+
+        m_wake.notify_all();
+
+        runWorker(0u);
+
+        std::unique_lock lock{m_mutex};
+        m_done.wait(lock, [&] { return m_running == 0u; });
+
+        m_task = nullptr;
+    }
+private:
+    // Own cache line each, workers hammer their own queue
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        uint64_t begin{0u};
+        uint64_t end{0u};
+    };
+
+    auto workerLoop(std::stop_token stop, uint32_t worker) -> void {
+        uint64_t seen_generation = 0u;
+
+        while (true) {
+            {
+                std::unique_lock lock{m_mutex};
+                m_wake.wait(lock, [&] { return stop.stop_requested() || m_generation != seen_generation; });
+
+                if (stop.stop_requested()) {
+                    return;
+                }
+
+                seen_generation = m_generation;
+            }
+
+            runWorker(worker);
+        }
+    }
+
+    auto runWorker(uint32_t worker) -> void {
+        uint64_t index = 0u;
+
+        do {
+            while (pop(worker, index)) {
+                m_task(index, worker);
+            }
+        } while (steal(worker));
+
+        std::lock_guard lock{m_mutex};
+        if (--m_running == 0u) {
+            m_done.notify_one();
+        }
+    }
+
+    auto pop(uint32_t worker, uint64_t& index) -> bool {
+        auto& queue = *m_queues[worker];
+
+        std::lock_guard lock{queue.mutex};
+        if (queue.begin == queue.end) {
+            return false;
+        }
+
+        index = queue.begin++;
+
+        return true;
+    }
+
+    /**
+     * @brief Moves the upper half of the fullest other queue into the worker's own.
+     */
+    auto steal(uint32_t worker) -> bool {
+        while (true) {
+            uint32_t victim = worker;
+            uint64_t most = 0u;
+
+            for (uint32_t i = 0u; i < m_queues.size(); i++) {
+                auto& queue = *m_queues[i];
+
+                std::lock_guard lock{queue.mutex};
+                if (i != worker && queue.end - queue.begin > most) {
+                    most = queue.end - queue.begin;
+                    victim = i;
+                }
+            }
+
+            if (victim == worker) {
+                return false; // nothing left anywhere
+            }
+
+            uint64_t begin = 0u;
+            uint64_t end = 0u;
+            {
+                auto& queue = *m_queues[victim];
+
+                std::lock_guard lock{queue.mutex};
+                if (queue.begin == queue.end) {
+                    continue; // drained in the meantime, look again
+                }
+
+                end = queue.end;
+                begin = queue.begin + (queue.end - queue.begin) / 2u;
+                queue.end = begin;
+            }
+
+            auto& own = *m_queues[worker];
+
+            std::lock_guard lock{own.mutex};
+            own.begin = begin;
+            own.end = end;
+
+            return true;
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    std::function<void(uint64_t, uint32_t)> m_task;
+    uint64_t m_generation{0u};
+    uint32_t m_running{0u};
+
+    std::vector<std::jthread> m_threads; // last, joined before anything else is destroyed
+}; // class WorkStealingPool
+
+} // namespace snek
@@ -0,0 +1,232 @@
+/**
+ * @file collision.hpp
+ *
+ * @brief Collision helpers shared by the simulation, free of any window/GL dependency.
+ *
+ * Besides the single pair test, collideMany() tests one rectangle against a structure of
+ * arrays of them, 4 (SSE) or 8 (AVX) at a time on x86-64. The kernel is picked at runtime
+ * by what the CPU supports, other targets use the scalar loop. Every kernel gives exactly
+ * the results of checkCollision(), NaNs included.
+ *
+ * It pays off against hundreds of rectangles and more. The board's own checks keep the pair
+ * test, its grid leaves a head only a few candidates.
+ *
+ * @authors Jacek Zub
+ */
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define SNEK_COLLISION_X86 1
+    #include <immintrin.h>
+
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define SNEK_TARGET_AVX
+    #else
+        #define SNEK_TARGET_AVX __attribute__((target("avx")))
+    #endif
+#endif
+
+namespace snek {
+
+constexpr auto checkCollision(
+    sf::FloatRect a,
+    sf::FloatRect b
+) -> bool {
+    const auto aleft = a.position.x ; const auto bleft = b.position.x;
+    const auto atop  = a.position.y ; const auto btop  = b.position.y;
+    const auto awidth  = a.size.x   ; const auto bwidth  = b.size.x;
+    const auto aheight = a.size.y   ; const auto bheight = b.size.y;
+
+    return !(aleft + awidth <= bleft ||
+             aleft >= bleft + bwidth ||
+             atop + aheight <= btop ||
+             atop >= btop + bheight);
+}
+
+/**
+ * @brief Rectangles as separate arrays of the same size, the layout the batch kernels load.
+ */
+struct RectArrays {
+    std::span<const float> x;
+    std::span<const float> y;
+    std::span<const float> width;
+    std::span<const float> height;
+
+    auto size() const -> size_t {
+        return x.size();
+    }
+};
+
+enum class CollisionKernel : uint8_t {
+    Scalar,
+    Sse, // 4 rectangles at a time, always there on x86-64
+    Avx, // 8 rectangles at a time
+};
+
+constexpr auto getName(CollisionKernel kernel) -> std::string_view {
+    switch (kernel) {
+        case CollisionKernel::Sse: return "sse";
+        case CollisionKernel::Avx: return "avx";
+        default: return "scalar";
+    }
+}
+
+namespace detail {
+
+inline auto collideScalar(const sf::FloatRect& a, const RectArrays& b, std::span<uint8_t> hits, size_t first) -> uint32_t {
+    uint32_t count = 0u;
+
+    for (size_t i = first; i < b.size(); i++) {
+        const bool hit = checkCollision(a, {{b.x[i], b.y[i]}, {b.width[i], b.height[i]}});
+
+        hits[i] = hit;
+        count += hit;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Spreads the low lanes bits of a movemask over as many hit bytes.
+ */
+inline auto storeHits(std::span<uint8_t> hits, size_t first, uint32_t mask, uint32_t lanes) -> uint32_t {
+    for (uint32_t lane = 0u; lane < lanes; lane++) {
+        hits[first + lane] = static_cast<uint8_t>((mask >> lane) & 1u);
+    }
+
+    return static_cast<uint32_t>(std::popcount(mask));
+}
+
+#ifdef SNEK_COLLISION_X86
+
+// The misses are the four comparisons of checkCollision(), ordered so they're false on NaN
+// like the scalar ones, and hits are what isn't a miss.
+
+inline auto collideSse(const sf::FloatRect& a, const RectArrays& b, std::span<uint8_t> hits) -> uint32_t {
+    const __m128 left = _mm_set1_ps(a.position.x);
+    const __m128 top = _mm_set1_ps(a.position.y);
+    const __m128 right = _mm_set1_ps(a.position.x + a.size.x);
+    const __m128 bottom = _mm_set1_ps(a.position.y + a.size.y);
+
+    uint32_t count = 0u;
+    size_t i = 0u;
+
+    for (; i + 4u <= b.size(); i += 4u) {
+        const __m128 x = _mm_loadu_ps(b.x.data() + i);
+        const __m128 y = _mm_loadu_ps(b.y.data() + i);
+        const __m128 x_end = _mm_add_ps(x, _mm_loadu_ps(b.width.data() + i));
+        const __m128 y_end = _mm_add_ps(y, _mm_loadu_ps(b.height.data() + i));
+
+        const __m128 miss = _mm_or_ps(
+            _mm_or_ps(_mm_cmple_ps(right, x), _mm_cmpge_ps(left, x_end)),
+            _mm_or_ps(_mm_cmple_ps(bottom, y), _mm_cmpge_ps(top, y_end)));
+
+        count += storeHits(hits, i, ~static_cast<uint32_t>(_mm_movemask_ps(miss)) & 0xFu, 4u);
+    }
+
+    return count + collideScalar(a, b, hits, i);
+}
+
+SNEK_TARGET_AVX inline auto collideAvx(const sf::FloatRect& a, const RectArrays& b, std::span<uint8_t> hits) -> uint32_t {
+    const __m256 left = _mm256_set1_ps(a.position.x);
+    const __m256 top = _mm256_set1_ps(a.position.y);
+    const __m256 right = _mm256_set1_ps(a.position.x + a.size.x);
+    const __m256 bottom = _mm256_set1_ps(a.position.y + a.size.y);
+
+    uint32_t count = 0u;
+    size_t i = 0u;
+
+    for (; i + 8u <= b.size(); i += 8u) {
+        const __m256 x = _mm256_loadu_ps(b.x.data() + i);
+        const __m256 y = _mm256_loadu_ps(b.y.data() + i);
+        const __m256 x_end = _mm256_add_ps(x, _mm256_loadu_ps(b.width.data() + i));
+        const __m256 y_end = _mm256_add_ps(y, _mm256_loadu_ps(b.height.data() + i));
+
+        const __m256 miss = _mm256_or_ps(
+            _mm256_or_ps(_mm256_cmp_ps(right, x, _CMP_LE_OQ), _mm256_cmp_ps(left, x_end, _CMP_GE_OQ)),
+            _mm256_or_ps(_mm256_cmp_ps(bottom, y, _CMP_LE_OQ), _mm256_cmp_ps(top, y_end, _CMP_GE_OQ)));
+
+        count += storeHits(hits, i, ~static_cast<uint32_t>(_mm256_movemask_ps(miss)) & 0xFFu, 8u);
+    }
+
+    return count + collideScalar(a, b, hits, i);
+}
+
+inline auto cpuHasAvx() -> bool {
+#if defined(_MSC_VER) && !defined(__clang__)
+    // AVX in the CPU, and the OS saving the YMM registers
+    std::array<int, 4> info{};
+    __cpuid(info.data(), 1);
+
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    const bool os_saves = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6u) == 0x6u;
+
+    return avx && os_saves;
+#else
+    return __builtin_cpu_supports("avx");
+#endif
+}
+
+#endif // SNEK_COLLISION_X86
+
+} // namespace detail
+
+inline auto isSupported(CollisionKernel kernel) -> bool {
+#ifdef SNEK_COLLISION_X86
+    static const bool avx = detail::cpuHasAvx();
+
+    return kernel != CollisionKernel::Avx || avx;
+#else
+    return kernel == CollisionKernel::Scalar;
+#endif
+}
+
+/**
+ * @brief The widest kernel this CPU runs, detected once.
+ */
+inline auto bestCollisionKernel() -> CollisionKernel {
+    static const auto kernel = isSupported(CollisionKernel::Avx) ? CollisionKernel::Avx
+        : isSupported(CollisionKernel::Sse) ? CollisionKernel::Sse
+        : CollisionKernel::Scalar;
+
+    return kernel;
+}
+
+/**
+ * @brief checkCollision(a, b[i]) for every i, written to hits[i] as 0 or 1.
+ *
+ * @param hits At least b.size() bytes.
+ * @param kernel Must be supported, see isSupported().
+ *
+ * @return How many of the rectangles a collides with.
+ */
+inline auto collideMany(
+    const sf::FloatRect& a,
+    const RectArrays& b,
+    std::span<uint8_t> hits,
+    CollisionKernel kernel = bestCollisionKernel()
+) -> uint32_t {
+#ifdef SNEK_COLLISION_X86
+    switch (kernel) {
+        case CollisionKernel::Avx: return detail::collideAvx(a, b, hits);
+        case CollisionKernel::Sse: return detail::collideSse(a, b, hits);
+        default: break;
+    }
+#else
+    (void)kernel;
+#endif
+
+    return detail::collideScalar(a, b, hits, 0u);
+}
+
+} // namespace snek
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <cstdint>
+#include <string_view>
 
 namespace snek {
 
@@ -15,22 +16,51 @@ namespace snek {
 constexpr uint32_t WINDOW_WIDTH = 800u;
 constexpr uint32_t WINDOW_HEIGHT = 600u;
 constexpr char WINDOW_TITLE[] = "Snek Game";
-constexpr uint32_t FRAMERATE_LIMIT = 60u;
+constexpr uint32_t FRAMERATE_LIMIT = 60u; // presentation only, 0 means uncapped
+
+// Simulation related
+constexpr uint32_t SIMULATION_TICK_RATE = 60u; // default ticks per second, independent of the framerate
+constexpr uint32_t SIMULATION_MAX_TICKS_PER_FRAME = 8u; // catch-up limit after a long stall
+
+// Input related
+constexpr uint32_t INPUT_QUEUE_CAPACITY = 32u; // input events waiting for a tick, more are dropped
+constexpr uint32_t INPUT_TURN_BUFFER_DEPTH = 2u; // default turns a board holds until the snake can take them
+constexpr uint32_t INPUT_TURN_BUFFER_MAX = 8u;
 
 // Game related
 constexpr float TILE_SIZE = 32.f;
-constexpr float SNAKE_INITIAL_SPEED = 4 * (TILE_SIZE / FRAMERATE_LIMIT); // 4 tiles per second
-constexpr float SNAKE_SPEED_INCREMENT = 0.5f * (TILE_SIZE / FRAMERATE_LIMIT); // increase speed by 0.5 tiles per second
+constexpr float SNAKE_INITIAL_SPEED = 4 * TILE_SIZE; // 4 tiles per second, in pixels per second
+constexpr float SNAKE_SPEED_INCREMENT = 0.5f * TILE_SIZE; // increase speed by 0.5 tiles per second
 constexpr uint32_t SNAKE_INITIAL_LENGTH = 5u;
+constexpr uint32_t BOARD_MAX_SIZE = 10'000u; // in tiles, per side
+constexpr uint32_t BOARD_TILES_PER_ROCK = 120u; // rock density of the default 40x30 board with 10 rocks
+constexpr uint32_t ENTITY_CHUNK_TILES = 32u; // side of the spatial chunks static entities are stored in
+
+// Bot related
+constexpr uint32_t AUTOPILOT_MAX_EXPANSIONS = 1u << 22; // cells a single path search may visit before giving up
+
+// Network related
+constexpr uint16_t NET_DEFAULT_PORT = 52'700u;
+constexpr uint32_t NET_PROTOCOL_VERSION = 1u;
+constexpr uint32_t NET_SNAPSHOT_HISTORY = 64u; // ticks of snapshots kept as delta baselines, a power of two
+constexpr uint32_t NET_INPUT_REDUNDANCY = 8u; // past inputs repeated in every input packet, covers lost ones
+constexpr float NET_POSITION_SCALE = 8.f; // snapshot positions are sent in 1/8 pixel steps
+constexpr float NET_CLIENT_TIMEOUT_SECONDS = 5.f; // a client silent this long loses its slot
 
 // Rendering related
 constexpr int32_t TEXTURE_TILE_SIZE = 64;
+constexpr uint32_t CAMERA_VIEW_TILES_X = 40u; // larger boards scroll, smaller ones are shown whole
+constexpr uint32_t CAMERA_VIEW_TILES_Y = 30u;
+constexpr uint32_t FLOOR_COLOR_LIGHT = 0x2E3B2AFFu; // checkerboard floor, RGBA
+constexpr uint32_t FLOOR_COLOR_DARK = 0x273324FFu;
 
 // Path prefix
 #define PATH_PREFIX "res/"
 
 // Texture paths
 constexpr std::string_view RESPATH_TEST_BMP = PATH_PREFIX "test.bmp";
+constexpr std::string_view RESPATH_SNAKE_SPRITES_PNG = PATH_PREFIX "assets/snake_sprites.png";
+constexpr std::string_view RESPATH_ATLAS_PNG = PATH_PREFIX "assets/atlas.png"; // built from the sprite sources by snek_atlas
 constexpr std::string_view RESPATH_ARIAL_TTF = PATH_PREFIX "arial.ttf";
 
 // Sound paths
@@ -7,28 +7,13 @@
  */
 #pragma once
 
-#include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/RenderWindow.hpp>
 
 #include "snek/constants.hpp"
+#include "snek/collision.hpp"
 
 namespace snek {
 
-constexpr auto checkCollision(
-    sf::FloatRect a,
-    sf::FloatRect b
-) -> bool {
-    const auto aleft = a.position.x ; const auto bleft = b.position.x;
-    const auto atop  = a.position.y ; const auto btop  = b.position.y;
-    const auto awidth  = a.size.x   ; const auto bwidth  = b.size.x;
-    const auto aheight = a.size.y   ; const auto bheight = b.size.y;
-
-    return !(aleft + awidth <= bleft ||
-             aleft >= bleft + bwidth ||
-             atop + aheight <= btop ||
-             atop >= btop + bheight);
-}
-
 inline auto createWindow(
     sf::Window& window,
     const sf::VideoMode& mode = sf::VideoMode{{WINDOW_WIDTH, WINDOW_HEIGHT}},
@@ -0,0 +1,165 @@
+/**
+ * @file arena.cpp
+ *
+ * @brief Arena stress test, ticks one board holding hundreds to thousands of bot snakes.
+ *
+ * Usage: snek_arena [snakes] [ticks] [threads] [seed] [free|grid] [--check]
+ *
+ * Every snake, the player's included, turns at random and away from walls and rocks right
+ * ahead. A new board is started when the player's snake dies. threads 0 uses every hardware
+ * thread. --check plays the same ticks again on one thread and fails unless both runs end
+ * on the same board.
+ *
+ * @authors Jacek Zub
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <print>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "snek/Arguments.hpp"
+#include "snek/Board.hpp"
+#include "snek/Controller.hpp"
+#include "snek/InputAction.hpp"
+#include "snek/Replay.hpp"
+#include "snek/WorkStealingPool.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct ArenaConfig {
+    uint32_t snakes{1000u};
+    uint64_t ticks{10'000u};
+    uint32_t seed{0u};
+    snek::Snake::Movement movement{snek::Snake::Movement::Free};
+};
+
+struct Run {
+    double seconds;
+    uint64_t snakeSteps;
+    uint64_t arenaDeaths;
+    uint64_t games;
+    uint64_t digest; // of the last board
+};
+
+auto play(const ArenaConfig& config, uint32_t threads) -> Run {
+    snek::WorkStealingPool pool{threads};
+
+    const auto make_board = [&](uint32_t game) {
+        snek::Board board{snek::Board::Config{
+            .width = 1000u,
+            .height = 1000u,
+            .rocks = 2000u,
+            .arenaSnakes = config.snakes,
+            .movement = config.movement,
+            .seed = config.seed + game}};
+        board.setPool(&pool);
+
+        return board;
+    };
+
+    // One small generator per snake, so bots can decide in parallel and stay deterministic
+    std::vector<std::minstd_rand> rngs;
+    for (uint32_t i = 0u; i <= config.snakes; i++) {
+        rngs.emplace_back(config.seed * 7919u + i + 1u);
+    }
+
+    std::vector<snek::InputAction> actions(config.snakes);
+    Run run{};
+
+    auto board = make_board(0u);
+    run.games = 1u;
+
+    const auto start = Clock::now();
+
+    for (uint64_t tick = 0u; tick < config.ticks; tick++) {
+        if (board.getState() != snek::Board::State::Playing) {
+            run.arenaDeaths += board.getArenaDeaths();
+            board = make_board(static_cast<uint32_t>(run.games++));
+        }
+
+        const auto arena = board.getArenaSnakes();
+        pool.parallelFor(arena.size(), [&](uint64_t i, uint32_t) {
+            actions[i] = snek::wander(board, arena[i], rngs[i + 1u]);
+        });
+
+        board.update(snek::wander(board, board.getSnake(), rngs[0]), actions);
+        run.snakeSteps += arena.size() + 1u;
+    }
+
+    run.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    run.arenaDeaths += board.getArenaDeaths();
+    run.digest = snek::digestBoard(board);
+
+    return run;
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int32_t {
+    std::vector<std::string_view> positional;
+    bool check = false;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string_view arg{argv[i]};
+
+        if (arg == "--check") {
+            check = true;
+        } else if (arg.starts_with("--")) {
+            std::println(stderr, "Unknown argument {}", arg);
+
+            return 1;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    ArenaConfig config;
+    const auto snakes = snek::positionalNumber(positional, 0u, "snakes", config.snakes);
+    const auto ticks = snek::positionalNumber(positional, 1u, "ticks", config.ticks);
+    const auto thread_count = snek::positionalNumber(positional, 2u, "threads", 0u);
+    const auto seed = snek::positionalNumber(positional, 3u, "seed", config.seed);
+    const auto movement = snek::positionalMovement(positional, 4u);
+
+    if (!snek::checkPositionalCount(positional, 5u) || !snakes || !ticks || !thread_count || !seed || !movement) {
+        return 1;
+    }
+
+    config.snakes = *snakes;
+    config.ticks = *ticks;
+    config.seed = *seed;
+    config.movement = *movement;
+
+    auto threads = *thread_count;
+    if (threads == 0u) {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    const auto run = play(config, threads);
+
+    std::println("snakes: {} + player, {} ticks on {} threads", config.snakes, config.ticks, threads);
+    std::println("elapsed: {:.3f} s", run.seconds);
+    std::println("ticks/s: {:.0f}", static_cast<double>(config.ticks) / run.seconds);
+    std::println("snake steps/s: {:.0f}", static_cast<double>(run.snakeSteps) / run.seconds);
+    std::println("arena deaths: {}, player games: {}", run.arenaDeaths, run.games);
+    std::println("digest: {:016x}", run.digest);
+
+    if (check) {
+        const auto single = play(config, 1u);
+
+        std::println("1 thread: {:.3f} s, digest {:016x}", single.seconds, single.digest);
+
+        if (single.digest != run.digest || single.arenaDeaths != run.arenaDeaths) {
+            std::println(stderr, "Arena diverged between {} threads and 1", threads);
+
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,207 @@
+/**
+ * @file batch.cpp
+ *
+ * @brief Batch simulation driver, plays many independent games of a bot across all cores.
+ *
+ * Usage: snek_batch [games] [threads] [seed] [free|grid] [--csv <file>] [--scaling] [--autopilot [astar|bfs]]
+ *
+ * The random bot plays unless --autopilot is given, which searches with A* by default.
+ * threads 0 uses every hardware thread. --csv writes one line per game, --scaling repeats
+ * the batch with 1, 2, 4, ... threads and reports the speedup over a single thread.
+ *
+ * @authors Jacek Zub
+ */
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <print>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "snek/Arguments.hpp"
+#include "snek/Autopilot.hpp"
+#include "snek/BatchRunner.hpp"
+#include "snek/Controller.hpp"
+#include "snek/WorkStealingPool.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Bot {
+    std::optional<snek::Autopilot::Search> autopilot; // the random bot when empty
+
+    auto operator()(uint32_t seed) const -> std::unique_ptr<snek::IController> {
+        if (autopilot) {
+            return std::make_unique<snek::Autopilot>(snek::Autopilot::Config{.search = *autopilot});
+        }
+
+        return std::make_unique<snek::RandomController>(~seed); // independent of the board's own stream
+    }
+};
+
+auto causeName(snek::Board::DeathCause cause) -> std::string_view {
+    switch (cause) {
+        case snek::Board::DeathCause::Wall: return "wall";
+        case snek::Board::DeathCause::Rock: return "rock";
+        case snek::Board::DeathCause::Self: return "self";
+        case snek::Board::DeathCause::Rival: return "rival";
+        default: return "none";
+    }
+}
+
+struct Timed {
+    std::vector<snek::GameResult> results;
+    double seconds;
+    uint64_t ticks;
+};
+
+auto timedBatch(uint32_t threads, const snek::BatchConfig& config, const Bot& bot) -> Timed {
+    snek::WorkStealingPool pool{threads};
+
+    const auto start = Clock::now();
+    auto results = snek::runBatch(pool, config, bot);
+    const auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    uint64_t ticks = 0u;
+    for (const auto& result : results) {
+        ticks += result.ticks;
+    }
+
+    return {std::move(results), seconds, ticks};
+}
+
+auto writeCsv(const std::string& path, const std::vector<snek::GameResult>& results) -> bool {
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        std::println(stderr, "Failed to open {}", path);
+
+        return false;
+    }
+
+    std::println(file, "seed,ticks,length,cause");
+    for (const auto& result : results) {
+        const auto cause = result.state == snek::Board::State::Won ? "won" : causeName(result.cause);
+
+        std::println(file, "{},{},{},{}", result.seed, result.ticks, result.length, cause);
+    }
+
+    std::fclose(file);
+
+    return true;
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int32_t {
+    std::vector<std::string_view> positional;
+    std::optional<std::string> csv_path;
+    bool scaling = false;
+    Bot bot;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string_view arg{argv[i]};
+
+        if (arg == "--csv") {
+            if (i + 1 == argc) {
+                std::println(stderr, "Missing value after {}", arg);
+
+                return 1;
+            }
+
+            csv_path = argv[++i];
+        } else if (arg == "--scaling") {
+            scaling = true;
+        } else if (arg == "--autopilot") {
+            bot.autopilot = snek::Autopilot::Search::AStar;
+
+            if (i + 1 < argc && std::string_view{argv[i + 1]} == "bfs") {
+                bot.autopilot = snek::Autopilot::Search::BreadthFirst;
+                i++;
+            } else if (i + 1 < argc && std::string_view{argv[i + 1]} == "astar") {
+                i++;
+            }
+        } else if (arg.starts_with("--")) {
+            std::println(stderr, "Unknown argument {}", arg);
+
+            return 1;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    const auto games = snek::positionalNumber(positional, 0u, "games", 10'000u);
+    const auto thread_count = snek::positionalNumber(positional, 1u, "threads", 0u);
+    const auto seed = snek::positionalNumber(positional, 2u, "seed", 0u);
+    const auto movement = snek::positionalMovement(positional, 3u);
+
+    if (!snek::checkPositionalCount(positional, 4u) || !games || !thread_count || !seed || !movement) {
+        return 1;
+    }
+
+    snek::BatchConfig config;
+    config.games = *games;
+    config.baseSeed = *seed;
+    config.board.movement = *movement;
+
+    if (config.games == 0u) {
+        std::println(stderr, "Nothing to play, games must be at least 1");
+
+        return 1;
+    }
+
+    auto threads = *thread_count;
+    if (threads == 0u) {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    const auto batch = timedBatch(threads, config, bot);
+
+    std::array<uint64_t, 5> causes{};
+    uint64_t won = 0u;
+    uint64_t length_sum = 0u;
+    for (const auto& result : batch.results) {
+        causes[static_cast<size_t>(result.cause)]++;
+        won += result.state == snek::Board::State::Won;
+        length_sum += result.length;
+    }
+
+    std::println("games: {} on {} threads", config.games, threads);
+    std::println("elapsed: {:.3f} s", batch.seconds);
+    std::println("games/s: {:.0f}", config.games / batch.seconds);
+    std::println("ticks/s: {:.0f}", static_cast<double>(batch.ticks) / batch.seconds);
+    std::println("avg ticks survived: {:.1f}", static_cast<double>(batch.ticks) / config.games);
+    std::println("avg length at end: {:.2f}", static_cast<double>(length_sum) / config.games);
+    std::println("ended by: wall {}, rock {}, self {}, won {}, tick limit {}",
+        causes[1], causes[2], causes[3], won, causes[0] - won);
+
+    if (csv_path && !writeCsv(*csv_path, batch.results)) {
+        return 1;
+    }
+
+    if (scaling) {
+        std::vector<uint32_t> counts;
+        for (uint32_t count = 1u; count < threads; count *= 2u) {
+            counts.push_back(count);
+        }
+        counts.push_back(threads);
+
+        const auto single = timedBatch(1u, config, bot);
+
+        std::println("{:>8} {:>12} {:>9} {:>11}", "threads", "ticks/s", "speedup", "efficiency");
+        for (const auto count : counts) {
+            const auto run = count == 1u ? single : timedBatch(count, config, bot);
+            const auto speedup = single.seconds / run.seconds;
+
+            std::println("{:>8} {:>12.0f} {:>8.2f}x {:>10.0f}%",
+                count, static_cast<double>(run.ticks) / run.seconds, speedup, speedup / count * 100.0);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,193 @@
+/**
+ * @file headless.cpp
+ * 
+ * @brief Headless simulation driver, ticks Boards as fast as the CPU allows.
+ *
+ * No window, GL context or audio device is created. Turns are chosen randomly,
+ * a new game is started whenever the snake dies.
+ *
+ * Usage: snek_headless [ticks] [seed] [free|grid]
+ *        snek_headless --record <file> [ticks] [seed] [free|grid]
+ *        snek_headless --replay <file> [seek_tick]
+ *
+ * --record saves the first game as a replay, --replay plays one back at full speed.
+ * 
+ * @authors Jacek Zub
+ */
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <print>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "snek/Arguments.hpp"
+#include "snek/Board.hpp"
+#include "snek/InputAction.hpp"
+#include "snek/Replay.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+auto secondsSince(Clock::time_point start) -> double {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+auto playReplay(std::string_view path, std::optional<uint64_t> seek_tick) -> int32_t {
+    const auto replay = snek::Replay::load(path);
+    if (!replay) {
+        return 1;
+    }
+
+    snek::ReplayPlayer player{*replay};
+
+    if (seek_tick) {
+        const auto start = Clock::now();
+        player.seek(*seek_tick);
+
+        std::println("seek to {}: {:.3f} ms", player.getTick(), secondsSince(start) * 1e3);
+    }
+
+    const auto first_tick = player.getTick();
+    const auto start = Clock::now();
+
+    while (player.step()) {}
+
+    const auto elapsed = secondsSince(start);
+    const auto ticks = player.getTick() - first_tick;
+
+    std::println("replay: {} ticks, seed {}", replay->tickCount, replay->config.seed.value_or(0u));
+    std::println("played: {} ticks in {:.3f} s", ticks, elapsed);
+    std::println("ticks/s: {:.0f}", static_cast<double>(ticks) / elapsed);
+    std::println("final length: {}", player.getBoard().getSnake().getLength());
+
+    if (const auto desync = player.getDesyncTick()) {
+        std::println(stderr, "desync: board differs from the recording at tick {}", *desync);
+
+        return 1;
+    }
+
+    return 0;
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int32_t {
+    std::optional<std::string_view> record_path;
+    std::optional<std::string_view> replay_path;
+    std::vector<std::string_view> positional;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string_view arg{argv[i]};
+
+        if (arg == "--record" || arg == "--replay") {
+            if (i + 1 == argc) {
+                std::println(stderr, "Missing value after {}", arg);
+
+                return 1;
+            }
+
+            (arg == "--record" ? record_path : replay_path) = argv[++i];
+        } else if (arg.starts_with("--")) {
+            std::println(stderr, "Unknown argument {}", arg);
+
+            return 1;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    if (record_path && replay_path) {
+        std::println(stderr, "--record and --replay can't be combined");
+
+        return 1;
+    }
+
+    if (replay_path) {
+        const auto seek_tick = snek::positionalNumber(positional, 0u, "seek tick", uint64_t{0u});
+        if (!snek::checkPositionalCount(positional, 1u) || !seek_tick) {
+            return 1;
+        }
+
+        return playReplay(*replay_path, positional.empty() ? std::nullopt : seek_tick);
+    }
+
+    const auto ticks = snek::positionalNumber(positional, 0u, "ticks", uint64_t{10'000'000u});
+    const auto seed_arg = snek::positionalNumber(positional, 1u, "seed", 0u);
+    const auto movement = snek::positionalMovement(positional, 2u);
+
+    if (!snek::checkPositionalCount(positional, 3u) || !ticks || !seed_arg || !movement) {
+        return 1;
+    }
+
+    const uint64_t total_ticks = *ticks;
+    const uint32_t seed = *seed_arg;
+
+    snek::Board::Config config;
+    config.seed = seed;
+    config.movement = *movement;
+
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<uint32_t> action_dist(0u, 15u);
+
+    const auto pick_action = [&]() -> snek::InputAction {
+        switch (action_dist(rng)) {
+            case 0u: return snek::InputAction::TurnLeft;
+            case 1u: return snek::InputAction::TurnRight;
+            default: return snek::InputAction::None;
+        }
+    };
+
+    snek::Board board{config};
+
+    std::optional<snek::ReplayRecorder> recorder;
+    if (record_path) {
+        recorder.emplace(board);
+    }
+
+    uint64_t games = 0u;
+    uint64_t length_sum = 0u;
+
+    const auto start = Clock::now();
+
+    for (uint64_t tick = 0u; tick < total_ticks; tick++) {
+        const auto action = pick_action();
+
+        if (recorder && games == 0u) {
+            recorder->record(board, action);
+        }
+
+        board.update(action);
+
+        if (board.getState() != snek::Board::State::Playing) {
+            games++;
+            length_sum += board.getSnake().getLength();
+
+            // Every game gets its own seed, still derived from the one given
+            config.seed = seed + static_cast<uint32_t>(games);
+            board = snek::Board{config};
+        }
+    }
+
+    const auto elapsed = secondsSince(start);
+
+    std::println("ticks: {}", total_ticks);
+    std::println("elapsed: {:.3f} s", elapsed);
+    std::println("ticks/s: {:.0f}", static_cast<double>(total_ticks) / elapsed);
+    std::println("games finished: {}", games);
+    if (games > 0u) {
+        std::println("avg length at death: {:.2f}", static_cast<double>(length_sum) / static_cast<double>(games));
+    }
+
+    if (recorder) {
+        if (!recorder->getReplay().save(*record_path)) {
+            return 1;
+        }
+
+        std::println("replay of the first game ({} ticks) written to {}", recorder->getReplay().tickCount, *record_path);
+    }
+
+    return 0;
+}
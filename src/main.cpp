@@ -6,6 +6,15 @@
  * @authors Jacek Zub
  */
 #include <SFML/Window.hpp>
+#include <SFML/Network/IpAddress.hpp>
+
+#include <charconv>
+#include <filesystem>
+#include <optional>
+#include <print>
+#include <string_view>
+#include <thread>
+#include <utility>
 
 #include "snek/constants.hpp"
 #include "snek/Entity.hpp"
@@ -13,23 +22,194 @@
 #include "snek/Renderer.hpp"
 #include "snek/Snake.hpp"
 #include "snek/Board.hpp"
+#include "snek/BoardLayer.hpp"
+#include "snek/BoardAudio.hpp"
+#include "snek/ClientLayer.hpp"
 #include "snek/Input.hpp"
+#include "snek/InputLatency.hpp"
+#include "snek/InputQueue.hpp"
 #include "snek/Menu.hpp"
+#include "snek/NetClient.hpp"
+#include "snek/FixedStepClock.hpp"
+#include "snek/DebugOverlay.hpp"
+#include "snek/Profiler.hpp"
+#include "snek/Replay.hpp"
+#include "snek/SoundSystem.hpp"
+#include "snek/AssetPack.hpp"
+
+namespace {
+
+constexpr std::string_view DEFAULT_TRACE_PATH = "snek_trace.json";
+constexpr std::string_view DEFAULT_PACK_PATH = "snek.pack";
+
+/**
+ * @brief Parses a board size like "1000x800", in tiles.
+ */
+auto parseBoardSize(std::string_view text) -> std::optional<std::pair<uint32_t, uint32_t>> {
+    const auto separator = text.find('x');
+    if (separator == std::string_view::npos) {
+        return std::nullopt;
+    }
+
+    uint32_t width = 0u;
+    uint32_t height = 0u;
+    const auto width_end = text.data() + separator;
+    const auto text_end = text.data() + text.size();
+
+    if (std::from_chars(text.data(), width_end, width).ptr != width_end ||
+        std::from_chars(width_end + 1, text_end, height).ptr != text_end) {
+        return std::nullopt;
+    }
+
+    if (width == 0u || height == 0u || width > snek::BOARD_MAX_SIZE || height > snek::BOARD_MAX_SIZE) {
+        return std::nullopt;
+    }
+
+    return std::pair{width, height};
+}
+
+/**
+ * @brief Parses a server address like "example.org:52700" or "127.0.0.1", NET_DEFAULT_PORT when none is given.
+ */
+auto parseServerAddress(std::string_view text) -> std::optional<std::pair<sf::IpAddress, uint16_t>> {
+    uint16_t port = snek::NET_DEFAULT_PORT;
+
+    if (const auto separator = text.rfind(':'); separator != std::string_view::npos) {
+        const auto port_text = text.substr(separator + 1u);
+        if (std::from_chars(port_text.data(), port_text.data() + port_text.size(), port).ptr != port_text.data() + port_text.size()) {
+            return std::nullopt;
+        }
+
+        text = text.substr(0u, separator);
+    }
+
+    const auto address = sf::IpAddress::resolve(text);
+    if (!address) {
+        return std::nullopt;
+    }
+
+    return std::pair{*address, port};
+}
+
+auto dumpTrace(std::string_view path) -> void {
+    if constexpr (!snek::profiler::ENABLED) {
+        std::println(stderr, "Profiling is disabled, rebuild with -DSNEK_ENABLE_PROFILER=ON");
+    } else if (snek::profiler::Profiler::writeChromeTrace(path)) {
+        std::println("Trace written to {}", path);
+    }
+}
+
+} // namespace
+
+/**
+ * Usage: snek_game [--trace <file>] [--record <file>] [--pack <file>] [--board <width>x<height>]
+ *                  [--connect <host>[:port]]
+ *
+ * --trace writes a Chrome trace of the recorded frames on exit, F2 writes one at any time.
+ * --record writes a replay of the game on exit, play it back with snek_headless --replay.
+ * --pack loads the assets from the given pack, snek.pack is used if present, else res/.
+ * --board sets the board size in tiles (up to BOARD_MAX_SIZE a side), the rock density stays
+ *         the default one and the camera follows the snake on boards larger than the view.
+ * --connect plays on a snek_server instead of the local board, skipping the menu.
+ */
+auto main(int argc, char** argv) -> int32_t {
+    std::optional<std::string_view> trace_path;
+    std::optional<std::string_view> record_path;
+    std::optional<std::string_view> pack_path;
+    std::optional<std::pair<sf::IpAddress, uint16_t>> server_address;
+    snek::Board::Config board_config;
+    for (int i = 1; i < argc; i++) {
+        const std::string_view arg{argv[i]};
+
+        const bool takes_value = arg == "--trace" || arg == "--record" || arg == "--pack" ||
+            arg == "--board" || arg == "--connect";
+        if (!takes_value) {
+            std::println(stderr, "Unknown argument {}", arg);
+
+            return 1;
+        }
+
+        if (i + 1 == argc) {
+            std::println(stderr, "Missing value after {}", arg);
+
+            return 1;
+        }
+
+        const std::string_view value{argv[++i]};
+
+        if (arg == "--trace") {
+            trace_path = value;
+        } else if (arg == "--record") {
+            record_path = value;
+        } else if (arg == "--pack") {
+            pack_path = value;
+        } else if (arg == "--board") {
+            const auto size = parseBoardSize(value);
+            if (!size) {
+                std::println(stderr, "Invalid board size {}, expected <width>x<height> up to {} a side",
+                    value, snek::BOARD_MAX_SIZE);
+
+                return 1;
+            }
+
+            board_config.width = size->first;
+            board_config.height = size->second;
+            board_config.rocks = size->first * size->second / snek::BOARD_TILES_PER_ROCK;
+        } else {
+            server_address = parseServerAddress(value);
+            if (!server_address) {
+                std::println(stderr, "Invalid server address {}, expected <host>[:port]", value);
+
+                return 1;
+            }
+        }
+    }
+
+    if (pack_path) {
+        if (!snek::AssetPack::mount(*pack_path)) {
+            return 1;
+        }
+    } else if (std::filesystem::exists(DEFAULT_PACK_PATH)) {
+        snek::AssetPack::mount(DEFAULT_PACK_PATH);
+    }
+
+    // Decode the game's assets in the background while the menu is already up,
+    // the main thread only waits if the game starts before they're done
+    snek::TextureManager::prefetch(snek::TextureId::Atlas);
+    std::jthread sound_loader{[] { snek::SoundSystem::Preload(); }};
 
-auto main() -> int32_t {
     sf::RenderWindow window;
     snek::createWindow(window);
 
     snek::Renderer renderer{window};
 
-    snek::Board board;
+    snek::Board board{board_config};
+    snek::BoardAudio board_audio;
+    board.addListener(&board_audio);
+
+    snek::BoardLayer board_layer{board};
+
+    std::optional<snek::ReplayRecorder> recorder;
+    if (record_path) {
+        board_layer.setRecorder(&recorder.emplace(board));
+    }
+
     snek::Menu main_menu;
     snek::Menu options_menu;
     snek::ILayer* current_layer = &main_menu;
 
+    // Client mode plays on the server right away, the local board is left alone
+    std::optional<snek::NetClient> net_client;
+    std::optional<snek::ClientLayer> client_layer;
+    if (server_address) {
+        net_client.emplace(server_address->first, server_address->second);
+        current_layer = &client_layer.emplace(*net_client);
+    }
+    uint32_t server_tick_rate = board.getTickRate();
+
     main_menu = snek::createMainMenu(
         &current_layer,
-        &board,
+        &board_layer,
         &options_menu,
         window
     );
@@ -39,29 +219,96 @@ auto main() -> int32_t {
         window
     );
 
+    sf::Clock frame_clock;
+    snek::FixedStepClock sim_clock{board.getTickRate()};
+    snek::InputQueue input_queue;
+    snek::InputLatency input_latency;
+
+    snek::DebugOverlay debug_overlay;
+
     while (window.isOpen()) {
-        const auto action = snek::poll_events(window);
+        SNEK_PROFILE_SCOPE("frame");
 
-        current_layer->update(action);
+        {
+            SNEK_PROFILE_SCOPE("poll_events");
+            snek::poll_events(window, input_queue);
+        }
+
+        // Ticks follow the server's rate, it's only known once joined
+        if (net_client && net_client->getWelcome() && net_client->getWelcome()->tickRate != server_tick_rate) {
+            server_tick_rate = net_client->getWelcome()->tickRate;
+            sim_clock.setTickRate(server_tick_rate);
+        }
+
+        const float frame_seconds = frame_clock.restart().asSeconds();
+        const auto ticks = sim_clock.advance(frame_seconds);
+
+        {
+            SNEK_PROFILE_SCOPE("update");
+
+            // Every tick consumes the oldest queued action, the rest wait for the next ticks,
+            // frames may run without ticking. Debug actions never reach the layers.
+            for (uint32_t i = 0u; i < ticks; i++) {
+                snek::TimedInput input;
+
+                while (const auto next = input_queue.pop()) {
+                    if (next->action == snek::InputAction::NextDebugPage) {
+                        debug_overlay.nextPage();
+                    } else if (next->action == snek::InputAction::DumpTrace) {
+                        dumpTrace(trace_path.value_or(DEFAULT_TRACE_PATH));
+                    } else {
+                        input = *next;
+                        break;
+                    }
+                }
+
+                if (current_layer == &board_layer) {
+                    input_latency.measure(board, input, [&] {
+                        current_layer->update(input.action);
+                    });
+                } else {
+                    current_layer->update(input.action);
+                }
+            }
+        }
 
-        renderer.beginFrame();
+        {
+            SNEK_PROFILE_SCOPE("render");
 
-        current_layer->render(renderer);
+            renderer.setInterpolation(sim_clock.getAlpha());
+            renderer.beginFrame();
 
-        if (current_layer == &board) {
-            std::vector<std::string> debug_lines;
-            for (const auto* entity : board.getEntities()) {
-                std::string line = 
-                    "Pos: (" + std::to_string(static_cast<int32_t>(entity->position.x)) + ", " +
-                    std::to_string(static_cast<int32_t>(entity->position.y)) + ") Dir: " +
-                    std::to_string(static_cast<int32_t>(entity->direction));
+            current_layer->render(renderer);
 
-                debug_lines.push_back(std::move(line));
+            if (current_layer == &board_layer) {
+                debug_overlay.render(renderer, board, input_latency, frame_seconds);
             }
-            renderer.debugText(debug_lines);
         }
 
-        renderer.endFrame();
+        {
+            SNEK_PROFILE_SCOPE("endFrame");
+            renderer.endFrame();
+        }
+    }
+
+    if (trace_path) {
+        dumpTrace(*trace_path);
+    }
+
+    if (input_latency.getSampleCount() > 0u) {
+        std::println("Input latency over {} turns: avg {:.1f} ms, max {:.1f} ms, {} turns dropped",
+            input_latency.getSampleCount(), input_latency.getAverageMs(), input_latency.getMaxMs(),
+            board.getTurnsDropped() + input_queue.getDroppedCount());
+    }
+
+    if (net_client && net_client->getSnapshotCount() > 0u) {
+        std::println("Received {} snapshots, {:.1f} bytes per snapshot",
+            net_client->getSnapshotCount(),
+            static_cast<double>(net_client->getBytesReceived()) / static_cast<double>(net_client->getSnapshotCount()));
+    }
+
+    if (recorder && recorder->getReplay().save(*record_path)) {
+        std::println("Replay written to {}", *record_path);
     }
 
     return 0;
@@ -0,0 +1,271 @@
+/**
+ * @file server.cpp
+ *
+ * @brief Authoritative snek server, clients join with snek_game --connect <host>[:port].
+ *
+ * Usage: snek_server [port] [slots] [seed] [free|grid] [--ticks <n>] [--clients <n>]
+ *
+ * Plays a 64x64 board with a snake per slot, slots nobody plays are steered by the server.
+ * The board starts over when slot 0's snake dies. Runs in real time until --ticks are
+ * played, printing the traffic every few seconds.
+ *
+ * --clients plays that many scripted clients on localhost against the server instead, tick
+ * for tick as fast as possible, and checks that every snapshot they decode matches the
+ * server's board. Reports bytes per tick per client both ways and how far off the clients'
+ * predicted snakes were.
+ *
+ * @authors Jacek Zub
+ */
+#include <SFML/Network/IpAddress.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <print>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "snek/Arguments.hpp"
+#include "snek/BitStream.hpp"
+#include "snek/constants.hpp"
+#include "snek/InputAction.hpp"
+#include "snek/NetClient.hpp"
+#include "snek/NetServer.hpp"
+#include "snek/NetState.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+auto average(double total, uint64_t count) -> double {
+    return count > 0u ? total / static_cast<double>(count) : 0.0;
+}
+
+auto serve(snek::NetServer& server, std::optional<uint64_t> ticks) -> int32_t {
+    const auto tick_duration = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / static_cast<double>(server.getBoard().getTickRate())));
+    const uint64_t report_ticks = server.getBoard().getTickRate() * 5u;
+
+    std::println("Listening on UDP port {}", server.getPort());
+
+    auto next_tick = Clock::now();
+    uint64_t reported_bytes = 0u;
+    uint64_t reported_client_ticks = 0u;
+
+    for (uint64_t tick = 1u; !ticks || tick <= *ticks; tick++) {
+        server.tick();
+
+        if (tick % report_ticks == 0u) {
+            const auto client_ticks = server.getClientTicks() - reported_client_ticks;
+
+            std::println("tick {}, match {}, {} clients, {:.1f} bytes per tick per client",
+                server.getTick(), server.getMatch(), server.getClientCount(),
+                average(static_cast<double>(server.getBytesSent() - reported_bytes), client_ticks));
+
+            reported_bytes = server.getBytesSent();
+            reported_client_ticks = server.getClientTicks();
+        }
+
+        next_tick += tick_duration;
+        std::this_thread::sleep_until(next_tick);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Server and scripted clients in lockstep: the server ticks, then every client does.
+ */
+auto playScripted(snek::NetServer& server, uint32_t client_count, uint64_t ticks, uint32_t seed) -> int32_t {
+    std::vector<std::unique_ptr<snek::NetClient>> clients;
+    std::vector<std::mt19937> rngs;
+    std::vector<std::optional<sf::Vector2f>> predictions(client_count); // head at the server's next tick
+
+    for (uint32_t i = 0u; i < client_count; i++) {
+        clients.push_back(std::make_unique<snek::NetClient>(sf::IpAddress::LocalHost, server.getPort()));
+        rngs.emplace_back(seed * 7919u + i + 1u);
+    }
+
+    uint64_t checked = 0u;
+    uint64_t mismatched = 0u;
+    uint64_t stale = 0u;
+    uint64_t predicted = 0u;
+    uint64_t predicted_closely = 0u;
+    double prediction_error = 0.0;
+    uint64_t full_bytes = 0u;
+    uint64_t full_count = 0u;
+
+    snek::BitWriter writer;
+    const auto start = Clock::now();
+
+    for (uint64_t tick = 0u; tick < ticks; tick++) {
+        server.tick();
+
+        // What the snapshot would cost without a baseline, for comparison
+        const auto* server_state = server.findState(server.getTick());
+        if (server_state != nullptr) {
+            writer.clear();
+            snek::encodeState(writer, *server_state, nullptr);
+            full_bytes += writer.getBytes().size();
+            full_count++;
+        }
+
+        for (uint32_t i = 0u; i < client_count; i++) {
+            auto& client = *clients[i];
+            const auto& welcome = client.getWelcome();
+
+            // The last prediction was made for this tick, unless the match started over since
+            if (predictions[i] && server_state != nullptr && welcome && welcome->match == server.getMatch()) {
+                const auto actual = server_state->snakes[welcome->slot].front().getPosition();
+
+                const auto error = std::hypot(actual.x - predictions[i]->x, actual.y - predictions[i]->y);
+
+                prediction_error += error;
+                predicted_closely += error <= 1.f ? 1u : 0u;
+                predicted++;
+            }
+            predictions[i].reset();
+
+            const auto roll = rngs[i]() % 16u;
+            const auto action = roll == 0u ? snek::InputAction::TurnLeft
+                : roll == 1u ? snek::InputAction::TurnRight
+                : snek::InputAction::None;
+
+            client.tick(action);
+
+            const auto* state = client.getState();
+            if (state == nullptr || !welcome || welcome->match != server.getMatch()) {
+                continue;
+            }
+
+            if (state->tick != server.getTick()) {
+                stale++;
+
+                continue;
+            }
+
+            checked++;
+            if (server_state == nullptr || *state != *server_state) {
+                mismatched++;
+            }
+
+            if (const auto snake = client.getPredictedSnake(); !snake.empty()) {
+                predictions[i] = snake.front().getPosition();
+            }
+        }
+    }
+
+    const auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    uint64_t client_bytes_sent = 0u;
+    uint64_t rejected = 0u;
+    for (const auto& client : clients) {
+        client_bytes_sent += client->getBytesSent();
+        rejected += client->getRejectedCount();
+    }
+
+    const auto client_ticks = server.getClientTicks();
+
+    std::println("clients: {} scripted, {} ticks, {} matches", client_count, ticks, server.getMatch());
+    std::println("elapsed: {:.3f} s, {:.0f} ticks/s", seconds, static_cast<double>(ticks) / seconds);
+    std::println("server -> client: {:.1f} bytes per tick per client", average(static_cast<double>(server.getBytesSent()), client_ticks));
+    std::println("client -> server: {:.1f} bytes per tick per client", average(static_cast<double>(client_bytes_sent), ticks * client_count));
+    std::println("full snapshot: {:.1f} bytes on average", average(static_cast<double>(full_bytes), full_count));
+    std::println("snapshots checked: {}, mismatched: {}, behind: {}, rejected: {}", checked, mismatched, stale, rejected);
+    std::println("prediction: {:.2f} px off on average over {} ticks, within 1 px {:.1f}% of them",
+        average(prediction_error, predicted), predicted,
+        average(static_cast<double>(predicted_closely) * 100.0, predicted));
+
+    if (mismatched > 0u || checked == 0u) {
+        std::println(stderr, "Clients decoded snapshots that don't match the server's board");
+
+        return 1;
+    }
+
+    return 0;
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int32_t {
+    std::vector<std::string_view> positional;
+    std::optional<uint64_t> ticks;
+    uint32_t scripted_clients = 0u;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string_view arg{argv[i]};
+
+        if (arg == "--ticks" || arg == "--clients") {
+            if (i + 1 == argc) {
+                std::println(stderr, "Missing value after {}", arg);
+
+                return 1;
+            }
+
+            const std::string_view value{argv[++i]};
+            bool valid = false;
+
+            if (arg == "--ticks") {
+                ticks = snek::parseNumber<uint64_t>(value);
+                valid = ticks.has_value();
+            } else {
+                const auto clients = snek::parseNumber<uint32_t>(value);
+                scripted_clients = clients.value_or(0u);
+                valid = clients.has_value();
+            }
+
+            if (!valid) {
+                std::println(stderr, "Invalid value {} after {}, expected a number", value, arg);
+
+                return 1;
+            }
+        } else if (arg.starts_with("--")) {
+            std::println(stderr, "Unknown argument {}", arg);
+
+            return 1;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    const auto port = snek::positionalNumber(positional, 0u, "port", snek::NET_DEFAULT_PORT);
+    const auto slots = snek::positionalNumber(positional, 1u, "slots", snek::NetServer::Config{}.slots);
+    const auto seed = snek::positionalNumber(positional, 2u, "seed", 0u);
+    const auto movement = snek::positionalMovement(positional, 3u);
+
+    if (!snek::checkPositionalCount(positional, 4u) || !port || !slots || !seed || !movement) {
+        return 1;
+    }
+
+    snek::NetServer::Config config;
+    config.port = *port;
+    config.slots = std::max(*slots, scripted_clients);
+    config.board.width = 64u;
+    config.board.height = 64u;
+    config.board.rocks = 40u;
+    if (positional.size() > 2u) {
+        config.board.seed = *seed;
+    }
+    config.board.movement = *movement;
+
+    // Scripted runs pick any free port, so they can run next to a real server
+    if (scripted_clients > 0u) {
+        config.port = 0u;
+    }
+
+    snek::NetServer server{config};
+    if (!server.isListening()) {
+        return 1;
+    }
+
+    if (scripted_clients > 0u) {
+        return playScripted(server, scripted_clients, ticks.value_or(2'000u), config.board.seed.value_or(0u));
+    }
+
+    return serve(server, ticks);
+}
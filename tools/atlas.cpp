@@ -0,0 +1,71 @@
+/**
+ * @file atlas.cpp
+ *
+ * @brief Offline atlas builder, composes the texture atlas from the sprite sources in Assets.hpp.
+ *
+ * Sprites are copied to the rects of ATLAS_LAYOUT, the same constexpr layout the game draws
+ * with, so the atlas image and the UV rects can't disagree. Run it from the directory the
+ * game runs from, the sprite sources are opened by their asset paths.
+ *
+ * Usage: snek_atlas [output]   (defaults to the atlas asset path)
+ *
+ * @authors Jacek Zub
+ */
+#include <SFML/Graphics/Image.hpp>
+
+#include <cstdint>
+#include <map>
+#include <print>
+#include <string>
+
+#include "snek/Assets.hpp"
+
+auto main(int argc, char** argv) -> int32_t {
+    const std::string output = argc > 1 ? argv[1] : std::string{snek::assetPath(snek::TextureId::Atlas)};
+
+    const auto atlas_size = snek::ATLAS_LAYOUT.size;
+    sf::Image atlas{
+        {static_cast<uint32_t>(atlas_size.x), static_cast<uint32_t>(atlas_size.y)},
+        sf::Color::Transparent
+    };
+
+    // Several sprites usually share a source sheet, decode each one once
+    std::map<std::string, sf::Image> sources;
+
+    for (size_t i = 0u; i < snek::SPRITE_ASSETS.size(); i++) {
+        const auto& sprite = snek::SPRITE_ASSETS[i];
+        const std::string source_path{sprite.source};
+
+        auto source = sources.find(source_path);
+        if (source == sources.end()) {
+            sf::Image image;
+            if (!image.loadFromFile(source_path)) {
+                std::println(stderr, "Failed to load sprite source: {}", source_path);
+
+                return 1;
+            }
+
+            source = sources.emplace(source_path, std::move(image)).first;
+        }
+
+        const auto& rect = snek::ATLAS_LAYOUT.rects[i];
+        const sf::Vector2u destination{static_cast<uint32_t>(rect.position.x), static_cast<uint32_t>(rect.position.y)};
+
+        if (!atlas.copy(source->second, destination, sprite.sourceRect)) {
+            std::println(stderr, "Sprite {} doesn't fit its source {}", sprite.name, source_path);
+
+            return 1;
+        }
+    }
+
+    if (!atlas.saveToFile(output)) {
+        std::println(stderr, "Failed to write atlas: {}", output);
+
+        return 1;
+    }
+
+    std::println("{}: {} sprites from {} sources, {}x{}", output, snek::SPRITE_ASSETS.size(), sources.size(),
+        atlas_size.x, atlas_size.y);
+
+    return 0;
+}
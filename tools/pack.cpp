@@ -0,0 +1,65 @@
+/**
+ * @file pack.cpp
+ *
+ * @brief Offline asset packer, bundles loose asset files into one snek asset pack.
+ *
+ * Every file is stored under the path exactly as given, so run it from the directory
+ * the game runs from, e.g. snek_pack snek.pack res/arial.ttf res/assets/snake_sprites.png
+ * A file made elsewhere is stored under the asset path before the '=' of <path>=<file>,
+ * e.g. res/assets/atlas.png=build/atlas.png
+ *
+ * Usage: snek_pack <output> <[path=]file...>
+ *
+ * @authors Jacek Zub
+ */
+#include <algorithm>
+#include <cstdint>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "snek/AssetPack.hpp"
+#include "snek/ByteStream.hpp"
+
+auto main(int argc, char** argv) -> int32_t {
+    if (argc < 3) {
+        std::println(stderr, "Usage: snek_pack <output> <[path=]file...>");
+
+        return 1;
+    }
+
+    std::vector<snek::AssetPack::Source> sources;
+    size_t total = 0u;
+
+    for (int i = 2; i < argc; i++) {
+        const std::string_view arg{argv[i]};
+        const auto separator = arg.find('=');
+        const auto file = separator == std::string_view::npos ? arg : arg.substr(separator + 1u);
+
+        snek::AssetPack::Source source;
+        source.path = arg.substr(0u, std::min(separator, arg.size()));
+
+        if (!snek::readFile(file, source.bytes)) {
+            return 1;
+        }
+
+        total += source.bytes.size();
+        sources.push_back(std::move(source));
+    }
+
+    const auto pack = snek::AssetPack::build(sources);
+    if (!pack.writeFile(argv[1])) {
+        return 1;
+    }
+
+    std::println("{}: {} assets, {} bytes of data, {} bytes total", argv[1], sources.size(), total, pack.getBytes().size());
+
+    // Read it back, a pack the game can't open is worse than none
+    const auto check = snek::AssetPack::open(argv[1]);
+    if (!check || check->getEntryCount() != sources.size()) {
+        return 1;
+    }
+
+    return 0;
+}